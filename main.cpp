@@ -11,6 +11,7 @@
 #include <QInputDialog>
 #include <QMessageBox>
 #include <QLabel>
+#include <QPointer>
 #include <cmath>
 
 #ifndef M_PI
@@ -21,9 +22,13 @@
 #include "src/image/Image.h"
 #include "src/image/PPM.h"
 #include "src/tools/Greyscale.h" // Dodany include
+#include "src/tools/ColorLUT.h" // Dodany include dla tablic 3D LUT
+#include "src/tools/ColorMatrix.h" // Dodany include dla macierzy kolorów
 #include "src/tools/Histogram.h" // Dodany include dla histogramu
 #include "src/tools/HistogramDisplay.h" // Dodany include dla wyświetlania histogramu
 #include "src/tools/Blur.h" // Dodany include dla rozmycia
+#include "src/tools/Median.h" // Dodany include dla filtru medianowego
+#include "src/tools/Bilateral.h" // Filtr bilateralny
 #include "src/tools/CustomBlurDialog.h" // Dodany include dla niestandardowego rozmycia
 #include "src/tools/EdgeDetection.h" // Dodany include dla wykrywania krawędzi
 #include "src/tools/HoughTransform.h" // Dodany include dla transformaty Hougha
@@ -45,6 +50,8 @@ int main(int argc, char *argv[]) {
   imageLabel->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
 
   std::unique_ptr<Image> image;
+  // Otwarte okno histogramu - odświeżane po każdej zmianie obrazu
+  QPointer<HistogramDisplay> histogramDialog;
 
   layout->addWidget(imageLabel);
 
@@ -57,8 +64,11 @@ int main(int argc, char *argv[]) {
 
   QAction *openAction = fileMenu->addAction("Open");
   QObject::connect(openAction, &QAction::triggered, &window,
-                   [&window, imageLabel, &image, fileManager]() {
+                   [&window, imageLabel, &image, fileManager, &histogramDialog]() {
                      fileManager->openFile(imageLabel, image);
+                     if (histogramDialog) {
+                       histogramDialog->imageChanged();
+                     }
                    });
 
   QAction *saveAction = fileMenu->addAction("Save");
@@ -68,10 +78,13 @@ int main(int argc, char *argv[]) {
   fileMenu->addSeparator();
 
   // Funkcja pomocnicza do aktualizacji widoku
-  auto updateImageView = [&image, imageLabel]() {
+  auto updateImageView = [&image, imageLabel, &histogramDialog]() {
     if (image) {
       imageLabel->setPixmap(QPixmap::fromImage(image->toQImage()));
     }
+    if (histogramDialog) {
+      histogramDialog->imageChanged();
+    }
   };
 
   // Dodanie akcji dla konwersji na skalę szarości
@@ -136,6 +149,62 @@ int main(int argc, char *argv[]) {
     }
   });
 
+  // Dodanie menu dla przekształceń macierzą kolorów
+  QMenu *colorMatrixMenu = toolsMenu->addMenu("Color Matrix");
+
+  QAction *sepiaAction = colorMatrixMenu->addAction("Sepia");
+  QObject::connect(sepiaAction, &QAction::triggered, &window, [&image, updateImageView]() {
+    if (image) {
+      ColorMatrix::sepia().apply(image);
+      updateImageView();
+    } else {
+      QMessageBox::warning(nullptr, "Error", "No image loaded.");
+    }
+  });
+
+  QAction *whiteBalanceAction = colorMatrixMenu->addAction("White Balance");
+  QObject::connect(whiteBalanceAction, &QAction::triggered, &window, [&image, updateImageView, &window]() {
+    if (image) {
+      bool ok1, ok2, ok3;
+      double gainR = QInputDialog::getDouble(&window, "White Balance", "Red gain (0.0 to 4.0):",
+                                             1.0, 0.0, 4.0, 2, &ok1);
+      if (!ok1) return;
+      double gainG = QInputDialog::getDouble(&window, "White Balance", "Green gain (0.0 to 4.0):",
+                                             1.0, 0.0, 4.0, 2, &ok2);
+      if (!ok2) return;
+      double gainB = QInputDialog::getDouble(&window, "White Balance", "Blue gain (0.0 to 4.0):",
+                                             1.0, 0.0, 4.0, 2, &ok3);
+      if (ok3) {
+        ColorMatrix::whiteBalance(static_cast<float>(gainR), static_cast<float>(gainG),
+                                  static_cast<float>(gainB)).apply(image);
+        updateImageView();
+      }
+    } else {
+      QMessageBox::warning(nullptr, "Error", "No image loaded.");
+    }
+  });
+
+  // Dodanie akcji dla tablicy 3D LUT wczytywanej z pliku .cube
+  QAction *colorLutAction = toolsMenu->addAction("Apply 3D LUT (.cube)");
+  QObject::connect(colorLutAction, &QAction::triggered, &window, [&image, updateImageView, &window]() {
+    if (image) {
+      QString filePath = QFileDialog::getOpenFileName(&window, "Open 3D LUT", "",
+                                                      "Cube LUT (*.cube)");
+      if (filePath.isEmpty()) {
+        return;
+      }
+      ColorLUT lut;
+      if (lut.load(filePath)) {
+        lut.apply(image);
+        updateImageView();
+      } else {
+        QMessageBox::warning(nullptr, "Error", "Could not load 3D LUT file.");
+      }
+    } else {
+      QMessageBox::warning(nullptr, "Error", "No image loaded.");
+    }
+  });
+
   // Dodanie separatora dla sekcji histogramu
   toolsMenu->addSeparator();
 
@@ -144,10 +213,16 @@ int main(int argc, char *argv[]) {
 
   // Akcja wyświetlania histogramu
   QAction *showHistogramAction = histogramMenu->addAction("Show Histogram");
-  QObject::connect(showHistogramAction, &QAction::triggered, &window, [&image, &window]() {
+  QObject::connect(showHistogramAction, &QAction::triggered, &window, [&image, &window, &histogramDialog]() {
     if (image) {
+      if (histogramDialog) {
+        // Okno jest już otwarte i odświeża się samo
+        histogramDialog->raise();
+        histogramDialog->activateWindow();
+        return;
+      }
       // Utworzenie i wyświetlenie okna z histogramami
-      auto histogramDialog = new HistogramDisplay(image, &window);
+      histogramDialog = new HistogramDisplay(image, &window);
       histogramDialog->setAttribute(Qt::WA_DeleteOnClose); // Automatyczne usuwanie okna po zamknięciu
       histogramDialog->show();
     } else {
@@ -179,6 +254,29 @@ int main(int argc, char *argv[]) {
     }
   });
 
+  // Akcja lokalnego wyrównywania histogramu (CLAHE)
+  QAction *claheAction = histogramMenu->addAction("CLAHE (Adaptive Equalization)");
+  QObject::connect(claheAction, &QAction::triggered, &window, [&image, updateImageView, &window]() {
+    if (image) {
+      bool ok1, ok2;
+      double clipLimit = QInputDialog::getDouble(&window, "CLAHE",
+                                                 "Clip limit (1.0 to 10.0):",
+                                                 2.0, 1.0, 10.0, 1, &ok1);
+      if (ok1) {
+        int gridSize = QInputDialog::getInt(&window, "CLAHE",
+                                            "Tile grid size (2 to 32):",
+                                            8, 2, 32, 1, &ok2);
+        if (ok2) {
+          Histogram::claheEqualization(image, clipLimit, gridSize);
+          updateImageView();
+          QMessageBox::information(nullptr, "Histogram", "Zastosowano CLAHE.");
+        }
+      }
+    } else {
+      QMessageBox::warning(nullptr, "Error", "No image loaded.");
+    }
+  });
+
   // Dodanie separatora dla sekcji rozmycia
   toolsMenu->addSeparator();
 
@@ -191,8 +289,8 @@ int main(int argc, char *argv[]) {
     if (image) {
       bool ok;
       double sigma = QInputDialog::getDouble(&window, "Gaussian Blur",
-                                           "Sigma value (0.5 to 10.0):",
-                                           1.0, 0.5, 10.0, 2, &ok);
+                                           "Sigma value (0.5 to 100.0):",
+                                           1.0, 0.5, 100.0, 2, &ok);
       if (ok) {
         Blur::gaussianBlur(image, sigma);
         updateImageView();
@@ -209,8 +307,8 @@ int main(int argc, char *argv[]) {
     if (image) {
       bool ok;
       int kernelSize = QInputDialog::getInt(&window, "Uniform Blur",
-                                          "Kernel size (3 to 15):",
-                                          5, 3, 15, 2, &ok);
+                                          QString("Kernel size (3 to %1):").arg(Blur::MaxUniformKernelSize),
+                                          5, 3, Blur::MaxUniformKernelSize, 2, &ok);
       if (ok) {
         Blur::uniformBlur(image, kernelSize);
         updateImageView();
@@ -221,6 +319,76 @@ int main(int argc, char *argv[]) {
     }
   });
 
+  // Akcja filtru medianowego (usuwanie szumu typu sól i pieprz)
+  QAction *medianAction = blurMenu->addAction("Median Filter");
+  QObject::connect(medianAction, &QAction::triggered, &window, [&image, updateImageView, &window]() {
+    if (image) {
+      bool ok;
+      int radius = QInputDialog::getInt(&window, "Median Filter",
+                                        "Radius (1 to 127):",
+                                        1, 1, Median::MaxRadius, 1, &ok);
+      if (ok) {
+        Median::medianFilter(image, radius);
+        updateImageView();
+        QMessageBox::information(nullptr, "Blur", "Filtr medianowy został zastosowany.");
+      }
+    } else {
+      QMessageBox::warning(nullptr, "Error", "No image loaded.");
+    }
+  });
+
+  // Akcja filtru bilateralnego (wygładzanie z zachowaniem krawędzi, siatka bilateralna)
+  QAction *bilateralAction = blurMenu->addAction("Bilateral Filter");
+  QObject::connect(bilateralAction, &QAction::triggered, &window, [&image, updateImageView, &window]() {
+    if (image) {
+      bool ok;
+      double sigmaSpatial = QInputDialog::getDouble(&window, "Bilateral Filter",
+                                                    "Spatial sigma in pixels (4.0 to 200.0):",
+                                                    8.0, Bilateral::MinSigmaSpatial, 200.0, 1, &ok);
+      if (!ok) {
+        return;
+      }
+      double sigmaRange = QInputDialog::getDouble(&window, "Bilateral Filter",
+                                                  "Range sigma in levels (5.0 to 128.0):",
+                                                  25.0, Bilateral::MinSigmaRange, 128.0, 1, &ok);
+      if (ok) {
+        Bilateral::bilateralFilter(image, sigmaSpatial, sigmaRange);
+        updateImageView();
+        QMessageBox::information(nullptr, "Blur", "Filtr bilateralny został zastosowany.");
+      }
+    } else {
+      QMessageBox::warning(nullptr, "Error", "No image loaded.");
+    }
+  });
+
+  // Akcja filtru prowadzonego (wygładzanie z zachowaniem krawędzi, koszt niezależny od promienia)
+  QAction *guidedAction = blurMenu->addAction("Guided Filter");
+  QObject::connect(guidedAction, &QAction::triggered, &window, [&image, updateImageView, &window]() {
+    if (image) {
+      bool ok;
+      int radius = QInputDialog::getInt(&window, "Guided Filter", "Radius (1 to 256):", 8, 1, 256, 1, &ok);
+      if (!ok) {
+        return;
+      }
+      double epsilon = QInputDialog::getDouble(&window, "Guided Filter",
+                                               "Epsilon (0.0001 to 1.0, e.g. 0.01 = 0.1²):",
+                                               0.01, 0.0001, 1.0, 4, &ok);
+      if (!ok) {
+        return;
+      }
+      QString guide = QInputDialog::getItem(&window, "Guided Filter", "Guide:",
+                                            {"Self (each channel)", "Luminance"}, 0, false, &ok);
+      if (ok) {
+        Blur::guidedFilter(image, radius, epsilon,
+                           guide == "Luminance" ? Blur::GuideMode::Luminance : Blur::GuideMode::Self);
+        updateImageView();
+        QMessageBox::information(nullptr, "Blur", "Filtr prowadzony został zastosowany.");
+      }
+    } else {
+      QMessageBox::warning(nullptr, "Error", "No image loaded.");
+    }
+  });
+
   // Akcja niestandardowego rozmycia z macierzą 3x3
   QAction *customBlurAction = blurMenu->addAction("Custom Matrix Blur");
   QObject::connect(customBlurAction, &QAction::triggered, &window, [&image, updateImageView, &window]() {
@@ -228,9 +396,10 @@ int main(int argc, char *argv[]) {
       CustomBlurDialog dialog(&window);
       if (dialog.exec() == QDialog::Accepted) {
         auto matrix = dialog.getMatrix();
-        Blur::customMatrixBlur(image, matrix);
+        std::string path = Blur::customMatrixBlur(image, matrix);
         updateImageView();
-        QMessageBox::information(nullptr, "Blur", "Niestandardowe rozmycie zostało zastosowane.");
+        QMessageBox::information(nullptr, "Blur", QString("Niestandardowe rozmycie zostało zastosowane.\nMetoda: %1")
+                                                      .arg(QString::fromStdString(path)));
       }
     } else {
       QMessageBox::warning(nullptr, "Error", "No image loaded.");
@@ -490,6 +659,30 @@ int main(int argc, char *argv[]) {
     }
   });
 
+  // Akcja binaryzacji adaptacyjnej metodą Sauvoli (próg lokalny, nierównomierne oświetlenie)
+  QAction *sauvolaBinarizationAction = binarizationMenu->addAction("Sauvola Adaptive Binarization");
+  QObject::connect(sauvolaBinarizationAction, &QAction::triggered, &window, [&image, updateImageView, &window]() {
+    if (image) {
+      bool ok;
+      int windowSize = QInputDialog::getInt(&window, "Sauvola Binarization",
+                                            "Window size (3 to 1001):",
+                                            31, 3, 1001, 2, &ok);
+      if (!ok) {
+        return;
+      }
+      double k = QInputDialog::getDouble(&window, "Sauvola Binarization",
+                                         "Sensitivity k (0.05 to 1.0):",
+                                         0.34, 0.05, 1.0, 2, &ok);
+      if (ok) {
+        Binarization::sauvolaBinarization(image, windowSize, k);
+        updateImageView();
+        QMessageBox::information(nullptr, "Binarization", "Binaryzacja adaptacyjna Sauvoli została zastosowana.");
+      }
+    } else {
+      QMessageBox::warning(nullptr, "Error", "No image loaded.");
+    }
+  });
+
   // Dodanie separatora dla sekcji segmentacji
   toolsMenu->addSeparator();
 
@@ -0,0 +1,631 @@
+#include "Convolution.h"
+#include "FFT.h"
+#include "FixedConvolution.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CONVOLUTION_SSE2 1
+#endif
+
+namespace {
+
+// dst[x] = suma kernel[i] * src[x + i] - src musi mieć count + size - 1 elementów
+void convolveLine(const float* src, float* dst, int count, const float* kernel, int size) {
+    int x = 0;
+#ifdef CONVOLUTION_SSE2
+    for (; x + 8 <= count; x += 8) {
+        __m128 acc0 = _mm_setzero_ps();
+        __m128 acc1 = _mm_setzero_ps();
+        for (int i = 0; i < size; ++i) {
+            __m128 w = _mm_set1_ps(kernel[i]);
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(w, _mm_loadu_ps(src + x + i)));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(w, _mm_loadu_ps(src + x + 4 + i)));
+        }
+        _mm_storeu_ps(dst + x, acc0);
+        _mm_storeu_ps(dst + x + 4, acc1);
+    }
+#endif
+    for (; x < count; ++x) {
+        float acc = 0.0f;
+        for (int i = 0; i < size; ++i) {
+            acc += kernel[i] * src[x + i];
+        }
+        dst[x] = acc;
+    }
+}
+
+// Jak convolveLine, dla jądra symetrycznego: pary src[x + i] i src[x + size - 1 - i]
+// mają tę samą wagę, więc mnożeń jest o połowę mniej
+void convolveLineSymmetric(const float* src, float* dst, int count, const float* kernel, int size) {
+    int radius = size / 2;
+    int x = 0;
+#ifdef CONVOLUTION_SSE2
+    // Dwa niezależne akumulatory (8 wyników naraz), aby nie czekać na opóźnienie dodawania
+    for (; x + 8 <= count; x += 8) {
+        __m128 w = _mm_set1_ps(kernel[radius]);
+        __m128 acc0 = _mm_mul_ps(w, _mm_loadu_ps(src + x + radius));
+        __m128 acc1 = _mm_mul_ps(w, _mm_loadu_ps(src + x + 4 + radius));
+        for (int i = 0; i < radius; ++i) {
+            const float* a = src + x + i;
+            const float* b = src + x + size - 1 - i;
+            w = _mm_set1_ps(kernel[i]);
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(w, _mm_add_ps(_mm_loadu_ps(a), _mm_loadu_ps(b))));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(w, _mm_add_ps(_mm_loadu_ps(a + 4), _mm_loadu_ps(b + 4))));
+        }
+        _mm_storeu_ps(dst + x, acc0);
+        _mm_storeu_ps(dst + x + 4, acc1);
+    }
+#endif
+    for (; x < count; ++x) {
+        float acc = kernel[radius] * src[x + radius];
+        for (int i = 0; i < radius; ++i) {
+            acc += kernel[i] * (src[x + i] + src[x + size - 1 - i]);
+        }
+        dst[x] = acc;
+    }
+}
+
+// acc[x] += weight * row[x]
+void accumulateRow(float* acc, const float* row, float weight, int count) {
+    int x = 0;
+#ifdef CONVOLUTION_SSE2
+    __m128 w = _mm_set1_ps(weight);
+    for (; x + 4 <= count; x += 4) {
+        _mm_storeu_ps(acc + x, _mm_add_ps(_mm_loadu_ps(acc + x), _mm_mul_ps(w, _mm_loadu_ps(row + x))));
+    }
+#endif
+    for (; x < count; ++x) {
+        acc[x] += weight * row[x];
+    }
+}
+
+// acc[x] += weight * (rowA[x] + rowB[x])
+void accumulateRowPair(float* acc, const float* rowA, const float* rowB, float weight, int count) {
+    int x = 0;
+#ifdef CONVOLUTION_SSE2
+    __m128 w = _mm_set1_ps(weight);
+    for (; x + 4 <= count; x += 4) {
+        __m128 pair = _mm_add_ps(_mm_loadu_ps(rowA + x), _mm_loadu_ps(rowB + x));
+        _mm_storeu_ps(acc + x, _mm_add_ps(_mm_loadu_ps(acc + x), _mm_mul_ps(w, pair)));
+    }
+#endif
+    for (; x < count; ++x) {
+        acc[x] += weight * (rowA[x] + rowB[x]);
+    }
+}
+
+// acc[x] += suma po j < 4 weights[j] * (rowsA[j][x] + rowsB[j][x]) - cztery pary wierszy naraz,
+// aby akumulator był czytany i zapisywany czterokrotnie rzadziej
+void accumulateRowPairs4(float* acc, const float* const* rowsA, const float* const* rowsB,
+                         const float* weights, int count) {
+    int x = 0;
+#ifdef CONVOLUTION_SSE2
+    __m128 w0 = _mm_set1_ps(weights[0]), w1 = _mm_set1_ps(weights[1]);
+    __m128 w2 = _mm_set1_ps(weights[2]), w3 = _mm_set1_ps(weights[3]);
+    for (; x + 4 <= count; x += 4) {
+        __m128 sum = _mm_loadu_ps(acc + x);
+        sum = _mm_add_ps(sum, _mm_mul_ps(w0, _mm_add_ps(_mm_loadu_ps(rowsA[0] + x), _mm_loadu_ps(rowsB[0] + x))));
+        sum = _mm_add_ps(sum, _mm_mul_ps(w1, _mm_add_ps(_mm_loadu_ps(rowsA[1] + x), _mm_loadu_ps(rowsB[1] + x))));
+        sum = _mm_add_ps(sum, _mm_mul_ps(w2, _mm_add_ps(_mm_loadu_ps(rowsA[2] + x), _mm_loadu_ps(rowsB[2] + x))));
+        sum = _mm_add_ps(sum, _mm_mul_ps(w3, _mm_add_ps(_mm_loadu_ps(rowsA[3] + x), _mm_loadu_ps(rowsB[3] + x))));
+        _mm_storeu_ps(acc + x, sum);
+    }
+#endif
+    for (; x < count; ++x) {
+        float sum = acc[x];
+        for (int j = 0; j < 4; ++j) {
+            sum += weights[j] * (rowsA[j][x] + rowsB[j][x]);
+        }
+        acc[x] = sum;
+    }
+}
+
+bool isSymmetric(const std::vector<float>& kernel) {
+    return std::equal(kernel.begin(), kernel.begin() + kernel.size() / 2, kernel.rbegin());
+}
+
+inline int toChannel(float value) {
+    return std::clamp(static_cast<int>(value + 0.5f), 0, 255);
+}
+
+// Płaszczyzny kanałów źródła (float, wiersz po wierszu) i odbiorca wyniku:
+// sink(kanał, y, x0, count, wartości) dla odcinka wiersza [x0, x0 + count)
+struct Source {
+    const float* const* planes;
+    int channels;
+    int width;
+    int height;
+    Convolution::Border border;
+};
+using Sink = std::function<void(int, int, int, int, const float*)>;
+
+// Wiersz y płaszczyzny uzupełniony wg trybu brzegu: line[i] = plane(x0 - left + i), i < count.
+// Tryb brzegu liczony jest tylko dla pikseli poza obrazem, wnętrze to zwykłe kopiowanie.
+void loadPaddedRow(const Source& source, int channel, int y, int x0, int left, int count, float* line) {
+    int sourceY = Convolution::borderIndex(y, source.height, source.border);
+    if (sourceY < 0) {
+        std::fill(line, line + count, 0.0f);
+        return;
+    }
+    const float* row = source.planes[channel] + static_cast<size_t>(sourceY) * source.width;
+    int first = x0 - left;
+    int interiorBegin = std::clamp(-first, 0, count);
+    int interiorEnd = std::clamp(source.width - first, interiorBegin, count);
+    for (int i = 0; i < interiorBegin; ++i) {
+        int x = Convolution::borderIndex(first + i, source.width, source.border);
+        line[i] = x < 0 ? 0.0f : row[x];
+    }
+    std::copy(row + first + interiorBegin, row + first + interiorEnd, line + interiorBegin);
+    for (int i = interiorEnd; i < count; ++i) {
+        int x = Convolution::borderIndex(first + i, source.width, source.border);
+        line[i] = x < 0 ? 0.0f : row[x];
+    }
+}
+
+// Przebieg pionowy jednej płaszczyzny: sumowanie całych wierszy w pasach kolumn, aby okno
+// kernelSize wierszy pasa mieściło się w pamięci podręcznej
+constexpr int StripWidth = 512;
+
+void verticalPass(const float* plane, int width, int height, const std::vector<float>& kernel,
+                  Convolution::Border border, const std::function<void(int, int, int, const float*)>& store) {
+    int kernelSize = static_cast<int>(kernel.size());
+    int kernelRadius = kernelSize / 2;
+    bool symmetric = isSymmetric(kernel);
+    std::vector<float> zeros(border == Convolution::Border::Constant ? width : 0, 0.0f);
+    
+    Parallel::forRange(height, [&](int begin, int end) {
+        std::vector<float> acc(StripWidth);
+        
+        for (int x0 = 0; x0 < width; x0 += StripWidth) {
+            int count = std::min(StripWidth, width - x0);
+            for (int y = begin; y < end; ++y) {
+                auto row = [&](int i) -> const float* {
+                    int sourceY = Convolution::borderIndex(y + i - kernelRadius, height, border);
+                    return sourceY < 0 ? zeros.data() + x0 : plane + static_cast<size_t>(sourceY) * width + x0;
+                };
+                std::fill(acc.begin(), acc.end(), 0.0f);
+                if (symmetric) {
+                    accumulateRow(acc.data(), row(kernelRadius), kernel[kernelRadius], count);
+                    int i = 0;
+                    for (; i + 4 <= kernelRadius; i += 4) {
+                        const float* rowsA[4];
+                        const float* rowsB[4];
+                        for (int j = 0; j < 4; ++j) {
+                            rowsA[j] = row(i + j);
+                            rowsB[j] = row(kernelSize - 1 - i - j);
+                        }
+                        accumulateRowPairs4(acc.data(), rowsA, rowsB, &kernel[i], count);
+                    }
+                    for (; i < kernelRadius; ++i) {
+                        accumulateRowPair(acc.data(), row(i), row(kernelSize - 1 - i), kernel[i], count);
+                    }
+                } else {
+                    for (int i = 0; i < kernelSize; ++i) {
+                        accumulateRow(acc.data(), row(i), kernel[i], count);
+                    }
+                }
+                store(y, x0, count, acc.data());
+            }
+        }
+    }, 16);
+}
+
+// Suma składników separowalnych, kanał po kanale (jedna płaszczyzna pośrednia naraz)
+void separablePath(const Source& source, const std::vector<KernelAnalysis::SeparableTerm>& terms, const Sink& sink) {
+    int width = source.width;
+    int height = source.height;
+    size_t planeSize = static_cast<size_t>(width) * height;
+    std::vector<float> intermediate(planeSize);
+    std::vector<float> sums(terms.size() > 1 ? planeSize : 0);
+    
+    for (int c = 0; c < source.channels; ++c) {
+        std::fill(sums.begin(), sums.end(), 0.0f);
+        for (size_t t = 0; t < terms.size(); ++t) {
+            std::vector<float> horizontal(terms[t].horizontal.begin(), terms[t].horizontal.end());
+            std::vector<float> vertical(terms[t].vertical.begin(), terms[t].vertical.end());
+            int size = static_cast<int>(horizontal.size());
+            int radius = size / 2;
+            bool symmetric = isSymmetric(horizontal);
+            
+            // Przebieg poziomy - wiersz z powielonymi brzegami
+            Parallel::forRange(height, [&](int begin, int end) {
+                std::vector<float> line(width + size - 1);
+                for (int y = begin; y < end; ++y) {
+                    loadPaddedRow(source, c, y, 0, radius, width + size - 1, line.data());
+                    float* dst = intermediate.data() + static_cast<size_t>(y) * width;
+                    if (symmetric) {
+                        convolveLineSymmetric(line.data(), dst, width, horizontal.data(), size);
+                    } else {
+                        convolveLine(line.data(), dst, width, horizontal.data(), size);
+                    }
+                }
+            }, 16);
+            
+            // Przebieg pionowy - jeden składnik od razu do wyniku, kilka sumowanych
+            if (terms.size() == 1) {
+                verticalPass(intermediate.data(), width, height, vertical, source.border,
+                             [&](int y, int x0, int count, const float* values) { sink(c, y, x0, count, values); });
+            } else {
+                verticalPass(intermediate.data(), width, height, vertical, source.border,
+                             [&](int y, int x0, int count, const float* values) {
+                    float* sum = sums.data() + static_cast<size_t>(y) * width + x0;
+                    for (int x = 0; x < count; ++x) {
+                        sum[x] += values[x];
+                    }
+                });
+            }
+        }
+        if (terms.size() > 1) {
+            Parallel::forRange(height, [&](int begin, int end) {
+                for (int y = begin; y < end; ++y) {
+                    sink(c, y, 0, width, sums.data() + static_cast<size_t>(y) * width);
+                }
+            }, 16);
+        }
+    }
+}
+
+// Bezpośredni splot 2D: dla każdego wiersza jądra jeden wiersz źródła z brzegami,
+// a każdy niezerowy współczynnik to jedno wektorowe acc += k * wiersz
+void directPath(const Source& source, const Kernel& kernel, const Sink& sink) {
+    int width = source.width;
+    int kernelWidth = kernel.width;
+    int kernelHeight = kernel.height;
+    int radiusX = kernelWidth / 2;
+    int radiusY = kernelHeight / 2;
+    
+    Parallel::forRange(source.height, [&](int begin, int end) {
+        std::vector<float> line(width + kernelWidth - 1);
+        std::vector<float> acc(width);
+        for (int y = begin; y < end; ++y) {
+            for (int c = 0; c < source.channels; ++c) {
+                std::fill(acc.begin(), acc.end(), 0.0f);
+                for (int ky = 0; ky < kernelHeight; ++ky) {
+                    loadPaddedRow(source, c, y + ky - radiusY, 0, radiusX, width + kernelWidth - 1, line.data());
+                    for (int kx = 0; kx < kernelWidth; ++kx) {
+                        float weight = static_cast<float>(kernel.at(kx, ky));
+                        if (weight != 0.0f) {
+                            accumulateRow(acc.data(), line.data() + kx, weight, width);
+                        }
+                    }
+                }
+                sink(c, y, 0, width, acc.data());
+            }
+        }
+    }, 16);
+}
+
+// Splot przez FFT metodą overlap-save: kafelek wyniku Tx x Ty liczony z fragmentu źródła
+// powiększonego o promień jądra, w transformacie n x n (n >= T + k - 1, więc bez zawijania).
+// Kafelki nie nachodzą na siebie w wyniku, więc liczone są równolegle bez synchronizacji.
+void fftPath(const Source& source, const Kernel& kernel, int n, const Sink& sink) {
+    int width = source.width;
+    int height = source.height;
+    int kernelWidth = kernel.width;
+    int kernelHeight = kernel.height;
+    int radiusX = kernelWidth / 2;
+    int radiusY = kernelHeight / 2;
+    int tileWidth = n - kernelWidth + 1;
+    int tileHeight = n - kernelHeight + 1;
+    int tilesX = (width + tileWidth - 1) / tileWidth;
+    int tilesY = (height + tileHeight - 1) / tileHeight;
+    
+    FFT fft(n);
+    
+    // Widmo jądra: współczynnik (kx, ky) mnoży piksel przesunięty o (kx - rx, ky - ry),
+    // czyli jako splot h(u, v) = kernel(rx - u, ry - v), indeksy ujemne zawinięte modulo n
+    std::vector<FFT::Complex> spectrum(static_cast<size_t>(n) * n);
+    for (int kx = 0; kx < kernelWidth; ++kx) {
+        for (int ky = 0; ky < kernelHeight; ++ky) {
+            int u = (radiusX - kx + n) % n;
+            int v = (radiusY - ky + n) % n;
+            spectrum[static_cast<size_t>(v) * n + u] = static_cast<float>(kernel.at(kx, ky));
+        }
+    }
+    fft.transform2D(spectrum.data(), false);
+    float scale = 1.0f / (static_cast<float>(n) * n);
+    
+    Parallel::forRange(tilesX * tilesY, [&](int begin, int end) {
+        std::vector<FFT::Complex> buffer(static_cast<size_t>(n) * n);
+        std::vector<float> lineA(tileWidth + kernelWidth - 1), lineB(tileWidth + kernelWidth - 1);
+        std::vector<float> outA(tileWidth), outB(tileWidth);
+        
+        for (int tile = begin; tile < end; ++tile) {
+            int x0 = (tile % tilesX) * tileWidth;
+            int y0 = (tile / tilesX) * tileHeight;
+            int countX = std::min(tileWidth, width - x0);
+            int countY = std::min(tileHeight, height - y0);
+            int spanX = countX + kernelWidth - 1;
+            int spanY = countY + kernelHeight - 1;
+            
+            // Kanały parami: a + i*b
+            for (int c = 0; c < source.channels; c += 2) {
+                bool paired = c + 1 < source.channels;
+                std::fill(buffer.begin(), buffer.end(), FFT::Complex());
+                for (int j = 0; j < spanY; ++j) {
+                    loadPaddedRow(source, c, y0 - radiusY + j, x0, radiusX, spanX, lineA.data());
+                    if (paired) {
+                        loadPaddedRow(source, c + 1, y0 - radiusY + j, x0, radiusX, spanX, lineB.data());
+                    }
+                    FFT::Complex* row = buffer.data() + static_cast<size_t>(j) * n;
+                    for (int i = 0; i < spanX; ++i) {
+                        row[i] = FFT::Complex(lineA[i], paired ? lineB[i] : 0.0f);
+                    }
+                }
+                
+                fft.transform2D(buffer.data(), false);
+                for (size_t i = 0; i < buffer.size(); ++i) {
+                    FFT::Complex a = buffer[i], b = spectrum[i];
+                    buffer[i] = FFT::Complex(a.real() * b.real() - a.imag() * b.imag(),
+                                             a.real() * b.imag() + a.imag() * b.real());
+                }
+                fft.transform2D(buffer.data(), true);
+                
+                for (int oy = 0; oy < countY; ++oy) {
+                    const FFT::Complex* row = buffer.data() + static_cast<size_t>(oy + radiusY) * n + radiusX;
+                    for (int ox = 0; ox < countX; ++ox) {
+                        outA[ox] = row[ox].real() * scale;
+                        outB[ox] = row[ox].imag() * scale;
+                    }
+                    sink(c, y0 + oy, x0, countX, outA.data());
+                    if (paired) {
+                        sink(c + 1, y0 + oy, x0, countX, outB.data());
+                    }
+                }
+            }
+        }
+    }, 1);
+}
+
+// Model kosztu (ns na jednostkę pracy, zmierzone na obrazie 2000x2000, jeden wątek, SSE2):
+// Direct - na współczynnik jądra i piksel kanału, Separable - na współczynnik 1D i piksel kanału
+// oraz na składnik i piksel kanału (płaszczyzna pośrednia), FFT - na n² log2(n) jednej
+// transformaty 2D (w tym wczytanie kafelka i mnożenie widm). Wspólny koszt rozpakowania
+// i zapisu pikseli jest pomijany.
+constexpr double DirectCost = 0.27;
+constexpr double SeparableCost = 0.27;
+constexpr double SeparableTermCost = 2.0;
+constexpr double FFTCost = 5.2;
+
+void runPlan(const Convolution::Plan& plan, const Source& source, const Kernel& kernel, const Sink& sink) {
+    switch (plan.path) {
+        case Convolution::Path::Separable:
+            separablePath(source, plan.decomposition.terms, sink);
+            break;
+        case Convolution::Path::FFT:
+            fftPath(source, kernel, plan.fftSize, sink);
+            break;
+        case Convolution::Path::Direct:
+        default:
+            directPath(source, kernel, sink);
+            break;
+    }
+}
+
+// Kanały R, G, B spakowanych pikseli jako trzy kolejne płaszczyzny float
+std::vector<float> unpackPlanes(const uint32_t* pixels, int width, int height) {
+    size_t planeSize = static_cast<size_t>(width) * height;
+    std::vector<float> planes(3 * planeSize);
+    Parallel::forRange(height, [&](int begin, int end) {
+        for (int y = begin; y < end; ++y) {
+            size_t offset = static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; ++x) {
+                uint32_t p = pixels[offset + x];
+                planes[offset + x] = static_cast<float>((p >> 16) & 0xFF);
+                planes[planeSize + offset + x] = static_cast<float>((p >> 8) & 0xFF);
+                planes[2 * planeSize + offset + x] = static_cast<float>(p & 0xFF);
+            }
+        }
+    }, 16);
+    return planes;
+}
+
+// Zapis odcinka wyniku do kanału spakowanych pikseli (pozostałe kanały i alfa bez zmian)
+void storeChannel(uint32_t* pixels, int width, int channel, int y, int x0, int count, const float* values,
+                  bool absolute) {
+    int shift = 16 - 8 * channel;
+    uint32_t* row = pixels + static_cast<size_t>(y) * width + x0;
+    for (int x = 0; x < count; ++x) {
+        float value = absolute ? std::abs(values[x]) : values[x];
+        row[x] = (row[x] & ~(0xFFu << shift)) | (static_cast<uint32_t>(toChannel(value)) << shift);
+    }
+}
+
+} // namespace
+
+int Convolution::borderIndex(int i, int n, Border border) {
+    if (i >= 0 && i < n) {
+        return i;
+    }
+    switch (border) {
+        case Border::Reflect: {
+            if (n == 1) {
+                return 0;
+            }
+            int period = 2 * (n - 1);
+            i = std::abs(i) % period;
+            return i < n ? i : period - i;
+        }
+        case Border::Wrap:
+            return (i % n + n) % n;
+        case Border::Constant:
+            return -1;
+        case Border::Replicate:
+        default:
+            return std::clamp(i, 0, n - 1);
+    }
+}
+
+void Convolution::loadPixelRow(const uint32_t* row, int width, int left, Border border, int16_t* const* channels) {
+    int count = width + 2 * left;
+    if (!row) {
+        for (int c = 0; c < 3; ++c) {
+            std::fill(channels[c], channels[c] + count, static_cast<int16_t>(0));
+        }
+        return;
+    }
+    for (int i = 0; i < count; ++i) {
+        // Wnętrze bez sprawdzania brzegu, tryb brzegu tylko dla skrajnych left pikseli
+        int x = i - left;
+        if (x < 0 || x >= width) {
+            x = borderIndex(x, width, border);
+        }
+        uint32_t p = x < 0 ? 0 : row[x];
+        channels[0][i] = static_cast<int16_t>((p >> 16) & 0xFF);
+        channels[1][i] = static_cast<int16_t>((p >> 8) & 0xFF);
+        channels[2][i] = static_cast<int16_t>(p & 0xFF);
+    }
+}
+
+Convolution::Plan Convolution::plan(const Kernel& kernel, int width, int height, int channels) {
+    Plan result;
+    int kernelWidth = kernel.width;
+    int kernelHeight = kernel.height;
+    double pixels = static_cast<double>(width) * height * channels;
+    
+    double best = DirectCost * kernelWidth * kernelHeight * pixels;
+    result.path = Path::Direct;
+    
+    result.decomposition = KernelAnalysis::decompose(kernel);
+    int rank = static_cast<int>(result.decomposition.terms.size());
+    if (rank > 0) {
+        double separable = (SeparableCost * (kernelWidth + kernelHeight) + SeparableTermCost) * rank * pixels;
+        if (separable < best) {
+            best = separable;
+            result.path = Path::Separable;
+        }
+    }
+    
+    // Najtańszy rozmiar transformaty: dwa kanały na transformatę, dwie transformaty (w przód i wstecz)
+    int largest = std::max(kernelWidth, kernelHeight);
+    for (int n = FFT::nextPowerOfTwo(2 * largest); n <= 2048; n <<= 1) {
+        int tilesX = (width + n - kernelWidth) / (n - kernelWidth + 1);
+        int tilesY = (height + n - kernelHeight) / (n - kernelHeight + 1);
+        double log2n = std::log2(static_cast<double>(n));
+        double fft = FFTCost * 2.0 * ((channels + 1) / 2) * tilesX * tilesY * static_cast<double>(n) * n * log2n;
+        if (fft < best) {
+            best = fft;
+            result.path = Path::FFT;
+            result.fftSize = n;
+        }
+        // Większe kafelki niż obraz nic już nie dają
+        if (n - kernelWidth + 1 >= width && n - kernelHeight + 1 >= height) {
+            break;
+        }
+    }
+    return result;
+}
+
+std::string Convolution::describe(const Plan& plan, const Kernel& kernel) {
+    std::string size = std::to_string(kernel.width) + "x" + std::to_string(kernel.height);
+    switch (plan.path) {
+        case Path::Separable: {
+            int rank = static_cast<int>(plan.decomposition.terms.size());
+            int passes = 2 * rank;
+            return "separowalny " + size + ", rząd " + std::to_string(rank) + " (" + std::to_string(passes) +
+                   (passes <= 4 ? " przebiegi 1D)" : " przebiegów 1D)");
+        }
+        case Path::FFT:
+            return "FFT " + size + ", kafelki " + std::to_string(plan.fftSize) + "x" + std::to_string(plan.fftSize);
+        case Path::Direct:
+        default:
+            return "splot 2D " + size;
+    }
+}
+
+std::string Convolution::apply(uint32_t* pixels, int width, int height, const Kernel& kernel,
+                               Output output, Border border) {
+    if (!kernel.isValid() || width <= 0 || height <= 0) {
+        return {};
+    }
+    Plan chosen = plan(kernel, width, height, 3);
+    
+    // Obraz 8-bit: najpierw ścieżka całkowita, gdy błąd kwantyzacji wag jest pomijalny
+    if (chosen.path == Path::Direct &&
+        FixedConvolution::applyDirect(pixels, width, height, kernel, output, border)) {
+        return describe(chosen, kernel) + ", stałoprzecinkowo";
+    }
+    if (chosen.path == Path::Separable && chosen.decomposition.terms.size() == 1) {
+        const KernelAnalysis::SeparableTerm& term = chosen.decomposition.terms.front();
+        if (FixedConvolution::applySeparable(pixels, width, height, term.horizontal, term.vertical, output, border)) {
+            return describe(chosen, kernel) + ", stałoprzecinkowo";
+        }
+    }
+    
+    // Wynik można zapisywać wprost do obrazu - źródłem są płaszczyzny
+    size_t planeSize = static_cast<size_t>(width) * height;
+    std::vector<float> planes = unpackPlanes(pixels, width, height);
+    const float* channels[3] = {planes.data(), planes.data() + planeSize, planes.data() + 2 * planeSize};
+    Source source{channels, 3, width, height, border};
+    
+    runPlan(chosen, source, kernel, [&](int channel, int y, int x0, int count, const float* values) {
+        storeChannel(pixels, width, channel, y, x0, count, values, output != Output::Clamp);
+    });
+    return describe(chosen, kernel);
+}
+
+void Convolution::applyMagnitude(uint32_t* pixels, int width, int height, const Kernel& kernelX,
+                                 const Kernel& kernelY, Border border) {
+    if (!kernelX.isValid() || !kernelY.isValid() || width <= 0 || height <= 0) {
+        return;
+    }
+    
+    size_t planeSize = static_cast<size_t>(width) * height;
+    std::vector<float> planes = unpackPlanes(pixels, width, height);
+    const float* channels[3] = {planes.data(), planes.data() + planeSize, planes.data() + 2 * planeSize};
+    Source source{channels, 3, width, height, border};
+    
+    // Najpierw odpowiedź na kernelX do płaszczyzn, potem kernelY łączona z nią w module
+    std::vector<float> responseX(3 * planeSize);
+    runPlan(plan(kernelX, width, height, 3), source, kernelX, [&](int channel, int y, int x0, int count, const float* values) {
+        std::copy(values, values + count, responseX.data() + channel * planeSize + static_cast<size_t>(y) * width + x0);
+    });
+    
+    runPlan(plan(kernelY, width, height, 3), source, kernelY, [&](int channel, int y, int x0, int count, const float* values) {
+        // Odbiorca wołany jest z wielu wątków - bufor osobny dla każdego
+        thread_local std::vector<float> buffer;
+        buffer.resize(count);
+        const float* gx = responseX.data() + channel * planeSize + static_cast<size_t>(y) * width + x0;
+        for (int x = 0; x < count; ++x) {
+            buffer[x] = std::sqrt(gx[x] * gx[x] + values[x] * values[x]);
+        }
+        storeChannel(pixels, width, channel, y, x0, count, buffer.data(), false);
+    });
+}
+
+std::string Convolution::applyPlane(const float* src, float* dst, int width, int height, const Kernel& kernel,
+                                    Border border) {
+    if (!kernel.isValid() || width <= 0 || height <= 0) {
+        return {};
+    }
+    Plan chosen = plan(kernel, width, height, 1);
+    Source source{&src, 1, width, height, border};
+    runPlan(chosen, source, kernel, [&](int, int y, int x0, int count, const float* values) {
+        std::copy(values, values + count, dst + static_cast<size_t>(y) * width + x0);
+    });
+    return describe(chosen, kernel);
+}
+
+void Convolution::applySeparable(uint32_t* pixels, int width, int height,
+                                 const std::vector<KernelAnalysis::SeparableTerm>& terms, Output output, Border border) {
+    if (terms.empty() || width <= 0 || height <= 0) {
+        return;
+    }
+    if (terms.size() == 1 &&
+        FixedConvolution::applySeparable(pixels, width, height, terms[0].horizontal, terms[0].vertical, output, border)) {
+        return;
+    }
+    
+    size_t planeSize = static_cast<size_t>(width) * height;
+    std::vector<float> planes = unpackPlanes(pixels, width, height);
+    const float* channels[3] = {planes.data(), planes.data() + planeSize, planes.data() + 2 * planeSize};
+    Source source{channels, 3, width, height, border};
+    
+    separablePath(source, terms, [&](int channel, int y, int x0, int count, const float* values) {
+        storeChannel(pixels, width, channel, y, x0, count, values, output != Output::Clamp);
+    });
+}
@@ -0,0 +1,82 @@
+#ifndef CONVOLUTION_H
+#define CONVOLUTION_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Kernel.h"
+#include "KernelAnalysis.h"
+
+// Jedyny silnik splotu programu: spakowany bufor pikseli (QRgb, 0xAARRGGBB, kanały R, G, B)
+// lub pojedyncza płaszczyzna float. Obliczenia na płaszczyznach float, praca rozdzielana
+// między wątki, jedna wektorowa pętla wewnętrzna (acc += waga * wiersz) dla wszystkich ścieżek.
+//
+// Ścieżka obliczeń wybierana jest modelem kosztu (plan):
+//  - Direct    - bezpośredni splot 2D, k_x * k_y mnożeń na piksel,
+//  - Separable - suma r par przebiegów 1D z rozkładu SVD, r * (k_x + k_y) mnożeń na piksel,
+//  - FFT       - kafelki overlap-save mnożone w dziedzinie częstotliwości, koszt prawie
+//                niezależny od rozmiaru jądra (duże jądra pełnego rzędu).
+// Dla spakowanych pikseli Direct i Separable rzędu 1 liczone są arytmetyką int16
+// (FixedConvolution), jeśli błąd kwantyzacji wag nie przekracza pół poziomu.
+//
+// Tryby wyniku: Clamp i Absolute (apply), moduł odpowiedzi dwóch jąder (applyMagnitude),
+// surowe wartości float (applyPlane).
+class Convolution {
+public:
+    // Jak traktowana jest wartość splotu przed zapisem do 0-255
+    enum class Output {
+        Clamp,   // zaokrąglenie i obcięcie
+        Absolute // wartość bezwzględna (filtry krawędzi), potem jak Clamp
+    };
+
+    // Wartości pikseli spoza obrazu. Wiersze źródła są uzupełniane wg trybu przed splotem,
+    // więc pętle wewnętrzne nie sprawdzają granic.
+    enum class Border {
+        Replicate, // najbliższy piksel brzegowy: aaa|abcd|ddd
+        Reflect,   // odbicie względem piksela brzegowego: dcb|abcd|cba
+        Wrap,      // obraz powtarzany okresowo: bcd|abcd|abc
+        Constant   // zero: 000|abcd|000
+    };
+
+    // Indeks piksela źródła dla współrzędnej i spoza [0, n) wg trybu brzegu; -1 oznacza zero (Constant)
+    static int borderIndex(int i, int n, Border border);
+
+    // Wiersz pikseli rozdzielony na kanały int16 z brzegiem wg trybu: channels[c][i] = row[i - left],
+    // i < width + 2 * left; row == nullptr daje wiersz zer (wspólne dla ścieżek całkowitych)
+    static void loadPixelRow(const uint32_t* row, int width, int left, Border border, int16_t* const* channels);
+
+    enum class Path { Direct, Separable, FFT };
+
+    struct Plan {
+        Path path = Path::Direct;
+        KernelAnalysis::Decomposition decomposition;
+        int fftSize = 0; // rozmiar transformaty (kafelka) dla Path::FFT
+    };
+
+    // Najtańsza ścieżka dla jądra i obrazu width x height o channels kanałach
+    static Plan plan(const Kernel& kernel, int width, int height, int channels);
+
+    // Opis ścieżki do wyświetlenia użytkownikowi
+    static std::string describe(const Plan& plan, const Kernel& kernel);
+
+    // Splot kanałów R, G, B ścieżką wybraną przez plan. Zwraca opis ścieżki (pusty przy błędnym jądrze).
+    static std::string apply(uint32_t* pixels, int width, int height, const Kernel& kernel,
+                             Output output = Output::Clamp, Border border = Border::Replicate);
+
+    // Moduł gradientu sqrt(gx² + gy²) dla każdego kanału (operatory Sobela, Prewitta, Robertsa)
+    static void applyMagnitude(uint32_t* pixels, int width, int height, const Kernel& kernelX,
+                               const Kernel& kernelY, Border border = Border::Replicate);
+
+    // Splot pojedynczej płaszczyzny float bez obcinania wyniku (src i dst nie mogą się pokrywać)
+    static std::string applyPlane(const float* src, float* dst, int width, int height, const Kernel& kernel,
+                                  Border border = Border::Replicate);
+
+    // Wynik = suma po składnikach: pionowe(poziome(obraz)), najpierw jądro horizontal wzdłuż x.
+    // Jądra o nieparzystej długości, środek w połowie; współczynnik kernel[i] dotyczy
+    // piksela przesuniętego o i - length / 2.
+    static void applySeparable(uint32_t* pixels, int width, int height,
+                               const std::vector<KernelAnalysis::SeparableTerm>& terms,
+                               Output output = Output::Clamp, Border border = Border::Replicate);
+};
+
+#endif // CONVOLUTION_H
@@ -0,0 +1,83 @@
+#include "FFT.h"
+#include <cmath>
+#include <utility>
+
+namespace {
+
+// Mnożenie bez obsługi NaN/inf ze standardu (std::complex wywołuje wtedy wolną funkcję biblioteczną)
+inline FFT::Complex multiply(FFT::Complex a, FFT::Complex b) {
+    return {a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real()};
+}
+
+} // namespace
+
+int FFT::nextPowerOfTwo(int n) {
+    int size = 1;
+    while (size < n) {
+        size <<= 1;
+    }
+    return size;
+}
+
+FFT::FFT(int n) : m_size(n), m_twiddles(n / 2), m_reversed(n) {
+    const double pi = std::acos(-1.0);
+    for (int k = 0; k < n / 2; ++k) {
+        double angle = -2.0 * pi * k / n;
+        m_twiddles[k] = Complex(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+    }
+    int bits = 0;
+    while ((1 << bits) < n) {
+        ++bits;
+    }
+    for (int i = 0; i < n; ++i) {
+        int reversed = 0;
+        for (int b = 0; b < bits; ++b) {
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        m_reversed[i] = reversed;
+    }
+}
+
+void FFT::transform(Complex* data, bool inverse) const {
+    int n = m_size;
+    for (int i = 0; i < n; ++i) {
+        if (i < m_reversed[i]) {
+            std::swap(data[i], data[m_reversed[i]]);
+        }
+    }
+    // Motylki Cooleya-Tukeya; dla transformaty odwrotnej sprzężone współczynniki obrotu
+    for (int length = 2; length <= n; length <<= 1) {
+        int half = length / 2;
+        int step = n / length;
+        for (int start = 0; start < n; start += length) {
+            for (int k = 0; k < half; ++k) {
+                Complex w = m_twiddles[k * step];
+                if (inverse) {
+                    w = std::conj(w);
+                }
+                Complex even = data[start + k];
+                Complex odd = multiply(data[start + k + half], w);
+                data[start + k] = even + odd;
+                data[start + k + half] = even - odd;
+            }
+        }
+    }
+}
+
+void FFT::transform2D(Complex* data, bool inverse) const {
+    int n = m_size;
+    for (int row = 0; row < n; ++row) {
+        transform(data + static_cast<size_t>(row) * n, inverse);
+    }
+    // Kolumny kopiowane do bufora, aby transformata działała na ciągłej pamięci
+    std::vector<Complex> column(n);
+    for (int x = 0; x < n; ++x) {
+        for (int y = 0; y < n; ++y) {
+            column[y] = data[static_cast<size_t>(y) * n + x];
+        }
+        transform(column.data(), inverse);
+        for (int y = 0; y < n; ++y) {
+            data[static_cast<size_t>(y) * n + x] = column[y];
+        }
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <complex>
+#include <vector>
+
+// Szybka transformata Fouriera radix-2 (rozmiary będące potęgą dwójki), bez zależności zewnętrznych.
+// Dane rzeczywiste przetwarzane są parami: dwie płaszczyzny a i b jako a + i*b - splot z jądrem
+// rzeczywistym nie miesza części rzeczywistej i urojonej, więc jedna transformata liczy dwa kanały.
+class FFT {
+public:
+    using Complex = std::complex<float>;
+
+    static int nextPowerOfTwo(int n);
+
+    // Przygotowana transformata n x n (tablice obrotów i odwrócenia bitów liczone raz)
+    explicit FFT(int n);
+
+    int size() const { return m_size; }
+
+    // Transformata 1D w miejscu; odwrotna bez dzielenia przez n
+    void transform(Complex* data, bool inverse) const;
+
+    // Transformata 2D n x n w miejscu (wiersze, potem kolumny); odwrotna bez dzielenia przez n²
+    void transform2D(Complex* data, bool inverse) const;
+
+private:
+    int m_size;
+    std::vector<Complex> m_twiddles; // e^(-2*pi*i*k/n), k < n / 2
+    std::vector<int> m_reversed;     // permutacja odwrócenia bitów
+};
+
+#endif // FFT_H
@@ -0,0 +1,257 @@
+#include "FixedConvolution.h"
+#include "HaloRows.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define FIXEDCONVOLUTION_SSE2 1
+#endif
+
+namespace {
+
+// Zapas na końcu wierszy: para współczynników (i, i + 1) czyta o jeden element dalej
+constexpr int RowSlack = 8;
+
+// acc[x] += weightA * a[x] + weightB * b[x]
+void accumulatePair(int32_t* acc, const int16_t* a, const int16_t* b, int16_t weightA, int16_t weightB, int count) {
+    int x = 0;
+#ifdef FIXEDCONVOLUTION_SSE2
+    __m128i weights = _mm_set1_epi32(static_cast<int32_t>(static_cast<uint16_t>(weightA)) |
+                                     static_cast<int32_t>(static_cast<uint32_t>(static_cast<uint16_t>(weightB)) << 16));
+    for (; x + 8 <= count; x += 8) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + x));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + x));
+        __m128i low = _mm_madd_epi16(_mm_unpacklo_epi16(va, vb), weights);
+        __m128i high = _mm_madd_epi16(_mm_unpackhi_epi16(va, vb), weights);
+        __m128i* out = reinterpret_cast<__m128i*>(acc + x);
+        _mm_storeu_si128(out, _mm_add_epi32(_mm_loadu_si128(out), low));
+        _mm_storeu_si128(out + 1, _mm_add_epi32(_mm_loadu_si128(out + 1), high));
+    }
+#endif
+    for (; x < count; ++x) {
+        acc[x] += weightA * a[x] + weightB * b[x];
+    }
+}
+
+// Zaokrąglenie acc / 2^shift, opcjonalnie moduł, obcięcie do 0-255
+inline uint32_t finish(int32_t acc, int shift, bool absolute) {
+    int64_t half = shift > 0 ? int64_t{1} << (shift - 1) : 0;
+    int64_t value = (acc + half) >> shift;
+    if (absolute) {
+        value = std::abs(value);
+    }
+    return static_cast<uint32_t>(std::clamp<int64_t>(value, 0, 255));
+}
+
+void storeChannel(uint32_t* row, const int32_t* acc, int count, int channel, int shift, bool absolute) {
+    int channelShift = 16 - 8 * channel;
+    for (int x = 0; x < count; ++x) {
+        row[x] = (row[x] & ~(0xFFu << channelShift)) | (finish(acc[x], shift, absolute) << channelShift);
+    }
+}
+
+double absoluteSum(const std::vector<double>& weights) {
+    double sum = 0.0;
+    for (double w : weights) {
+        sum += std::abs(w);
+    }
+    return sum;
+}
+
+} // namespace
+
+FixedConvolution::Quantized FixedConvolution::quantize(const std::vector<double>& weights, int sampleMax) {
+    Quantized result;
+    result.weights.assign(weights.size(), 0);
+    double largest = 0.0;
+    double sum = 0.0;
+    for (double w : weights) {
+        largest = std::max(largest, std::abs(w));
+        sum += w;
+    }
+    if (largest == 0.0) {
+        return result;
+    }
+
+    // Wagi w int16 i suma |q| * sampleMax w int32
+    double limit = std::min(32767.0 / largest, 2147483647.0 / (absoluteSum(weights) * std::max(sampleMax, 1) + 1.0));
+    int shift = std::min(30, static_cast<int>(std::floor(std::log2(limit))));
+    for (; shift >= 0; --shift) {
+        double scale = std::ldexp(1.0, shift);
+        long long total = 0;
+        long long absoluteTotal = 0;
+        size_t center = 0;
+        for (size_t i = 0; i < weights.size(); ++i) {
+            result.weights[i] = static_cast<int16_t>(std::lround(weights[i] * scale));
+            total += result.weights[i];
+            if (std::abs(weights[i]) > std::abs(weights[center])) {
+                center = i;
+            }
+        }
+        // Suma wag zaokrąglona jak suma oryginałów - płaskie obszary bez dryfu jasności (rozmycia)
+        long long correction = std::llround(sum * scale) - total;
+        long long adjusted = result.weights[center] + correction;
+        if (adjusted >= -32767 && adjusted <= 32767) {
+            result.weights[center] = static_cast<int16_t>(adjusted);
+        }
+        for (int16_t q : result.weights) {
+            absoluteTotal += std::abs(q);
+        }
+        if (absoluteTotal * std::max(sampleMax, 1) <= 2147483647LL - (1LL << shift)) {
+            result.shift = shift;
+            break;
+        }
+    }
+
+    double scale = std::ldexp(1.0, result.shift);
+    for (size_t i = 0; i < weights.size(); ++i) {
+        result.maxError += std::abs(weights[i] - result.weights[i] / scale);
+    }
+    result.maxError *= sampleMax;
+    return result;
+}
+
+bool FixedConvolution::applyDirect(uint32_t* pixels, int width, int height, const Kernel& kernel,
+                                   Convolution::Output output, Convolution::Border border) {
+    Quantized quantized = quantize(kernel.weights, 255);
+    if (quantized.maxError > MaxError) {
+        return false;
+    }
+
+    int kernelWidth = kernel.width;
+    int kernelHeight = kernel.height;
+    int radiusX = kernelWidth / 2;
+    int radiusY = kernelHeight / 2;
+    int paddedWidth = width + kernelWidth - 1 + RowSlack;
+    bool absolute = output == Convolution::Output::Absolute;
+
+    // Wynik zapisywany w miejscu - kopiowane są tylko wiersze przy granicach pasów
+    int bands = Parallel::bandCount(height, std::max(16, 2 * kernelHeight));
+    HaloRows source(pixels, width, height, bands, radiusY, border);
+
+    Parallel::forBands(height, bands, [&](int, int begin, int end) {
+        // Cykliczny bufor kernelHeight wierszy na kanał - każdy wiersz źródła wczytywany raz na pasmo
+        std::vector<int16_t> ring(3 * static_cast<size_t>(kernelHeight) * paddedWidth, 0);
+        auto slot = [&](int channel, int y) {
+            int index = (y % kernelHeight + kernelHeight) % kernelHeight;
+            return ring.data() + static_cast<size_t>(channel * kernelHeight + index) * paddedWidth;
+        };
+        auto load = [&](int y) {
+            int16_t* channels[3] = {slot(0, y), slot(1, y), slot(2, y)};
+            Convolution::loadPixelRow(source.row(y), width, radiusX, border, channels);
+        };
+        for (int y = begin - radiusY; y < begin + radiusY; ++y) {
+            load(y);
+        }
+
+        std::vector<int32_t> acc(width);
+        for (int y = begin; y < end; ++y) {
+            load(y + radiusY);
+            uint32_t* out = pixels + static_cast<size_t>(y) * width;
+            for (int c = 0; c < 3; ++c) {
+                std::fill(acc.begin(), acc.end(), 0);
+                for (int ky = 0; ky < kernelHeight; ++ky) {
+                    const int16_t* row = slot(c, y + ky - radiusY);
+                    const int16_t* weights = quantized.weights.data() + static_cast<size_t>(ky) * kernelWidth;
+                    for (int kx = 0; kx < kernelWidth; kx += 2) {
+                        int16_t weightB = kx + 1 < kernelWidth ? weights[kx + 1] : 0;
+                        if (weights[kx] != 0 || weightB != 0) {
+                            accumulatePair(acc.data(), row + kx, row + kx + 1, weights[kx], weightB, width);
+                        }
+                    }
+                }
+                storeChannel(out, acc.data(), width, c, quantized.shift, absolute);
+            }
+        }
+    });
+    return true;
+}
+
+bool FixedConvolution::applySeparable(uint32_t* pixels, int width, int height, const std::vector<double>& horizontal,
+                                      const std::vector<double>& vertical, Convolution::Output output,
+                                      Convolution::Border border) {
+    // Wynik pośredni int16 z fractionBits bitami ułamka: |suma| * 2^fractionBits <= 32767
+    double horizontalSum = absoluteSum(horizontal);
+    int fractionBits = static_cast<int>(std::floor(std::log2(32767.0 / (255.0 * std::max(horizontalSum, 1e-12)))));
+    Quantized quantizedH = quantize(horizontal, 255);
+    fractionBits = std::min({fractionBits, quantizedH.shift, 15});
+    if (fractionBits < 0) {
+        return false;
+    }
+    int intermediateMax = static_cast<int>(std::ceil(255.0 * horizontalSum * (1 << fractionBits)));
+    Quantized quantizedV = quantize(vertical, std::min(intermediateMax, 32767));
+
+    // Błąd: wagi poziome i zaokrąglenie wyniku pośredniego przenoszone przez jądro pionowe,
+    // plus kwantyzacja wag pionowych (maxError w jednostkach wyniku pośredniego)
+    double error = (quantizedH.maxError + 0.5 / (1 << fractionBits)) * absoluteSum(vertical) +
+                   quantizedV.maxError / (1 << fractionBits);
+    if (error > MaxError || quantizedV.shift + fractionBits > 30) {
+        return false;
+    }
+
+    int sizeH = static_cast<int>(horizontal.size());
+    int sizeV = static_cast<int>(vertical.size());
+    int radiusH = sizeH / 2;
+    int radiusV = sizeV / 2;
+    int paddedWidth = width + sizeH - 1 + RowSlack;
+    int horizontalShift = quantizedH.shift - fractionBits;
+    bool absolute = output == Convolution::Output::Absolute;
+
+    // Oba przebiegi w jednym przejściu pasa: wiersz źródła -> przebieg poziomy do bufora cyklicznego
+    // sizeV wierszy int16, potem przebieg pionowy po tym buforze i zapis w miejscu
+    int bands = Parallel::bandCount(height, std::max(16, 2 * sizeV));
+    HaloRows source(pixels, width, height, bands, radiusV, border);
+
+    Parallel::forBands(height, bands, [&](int, int begin, int end) {
+        std::vector<int16_t> rows(3 * static_cast<size_t>(paddedWidth), 0);
+        int16_t* channels[3] = {rows.data(), rows.data() + paddedWidth, rows.data() + 2 * paddedWidth};
+        std::vector<int16_t> ring(3 * static_cast<size_t>(sizeV) * (width + RowSlack), 0);
+        auto slot = [&](int channel, int y) {
+            int index = (y % sizeV + sizeV) % sizeV;
+            return ring.data() + static_cast<size_t>(channel * sizeV + index) * (width + RowSlack);
+        };
+        std::vector<int32_t> acc(width);
+        int32_t half = horizontalShift > 0 ? 1 << (horizontalShift - 1) : 0;
+
+        // Wynik przebiegu poziomego dla wiersza y (poza obrazem wg trybu brzegu)
+        auto load = [&](int y) {
+            Convolution::loadPixelRow(source.row(y), width, radiusH, border, channels);
+            for (int c = 0; c < 3; ++c) {
+                std::fill(acc.begin(), acc.end(), 0);
+                for (int i = 0; i < sizeH; i += 2) {
+                    int16_t weightB = i + 1 < sizeH ? quantizedH.weights[i + 1] : 0;
+                    accumulatePair(acc.data(), channels[c] + i, channels[c] + i + 1, quantizedH.weights[i], weightB, width);
+                }
+                int16_t* dst = slot(c, y);
+                for (int x = 0; x < width; ++x) {
+                    dst[x] = static_cast<int16_t>((acc[x] + half) >> horizontalShift);
+                }
+            }
+        };
+        for (int y = begin - radiusV; y < begin + radiusV; ++y) {
+            load(y);
+        }
+
+        for (int y = begin; y < end; ++y) {
+            load(y + radiusV);
+            uint32_t* out = pixels + static_cast<size_t>(y) * width;
+            for (int c = 0; c < 3; ++c) {
+                std::fill(acc.begin(), acc.end(), 0);
+                for (int i = 0; i < sizeV; i += 2) {
+                    const int16_t* rowA = slot(c, y + i - radiusV);
+                    if (i + 1 < sizeV) {
+                        accumulatePair(acc.data(), rowA, slot(c, y + i + 1 - radiusV), quantizedV.weights[i],
+                                       quantizedV.weights[i + 1], width);
+                    } else {
+                        accumulatePair(acc.data(), rowA, rowA, quantizedV.weights[i], 0, width);
+                    }
+                }
+                storeChannel(out, acc.data(), width, c, quantizedV.shift + fractionBits, absolute);
+            }
+        }
+    });
+    return true;
+}
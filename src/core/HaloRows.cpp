@@ -0,0 +1,37 @@
+#include "HaloRows.h"
+#include "Parallel.h"
+#include <algorithm>
+
+HaloRows::HaloRows(const uint32_t* pixels, int width, int height, int bands, int radius, Convolution::Border border)
+    : m_pixels(pixels), m_width(width), m_height(height), m_border(border), m_slots(std::max(height, 0), -1) {
+    int count = 0;
+    // Granice pasów łącznie z 0 i height (brzegi obrazu)
+    for (int band = 0; band <= bands; ++band) {
+        int boundary = Parallel::bandBegin(height, bands, band);
+        int from = std::max(0, boundary - radius - 1);
+        int to = std::min(height, boundary + radius + 1);
+        for (int y = from; y < to; ++y) {
+            if (m_slots[y] < 0) {
+                m_slots[y] = count++;
+            }
+        }
+    }
+
+    m_rows.resize(static_cast<size_t>(count) * width);
+    for (int y = 0; y < height; ++y) {
+        if (m_slots[y] >= 0) {
+            const uint32_t* source = pixels + static_cast<size_t>(y) * width;
+            std::copy(source, source + width, m_rows.data() + static_cast<size_t>(m_slots[y]) * width);
+        }
+    }
+}
+
+const uint32_t* HaloRows::row(int y) const {
+    int sourceY = Convolution::borderIndex(y, m_height, m_border);
+    if (sourceY < 0) {
+        return nullptr;
+    }
+    int slot = m_slots[sourceY];
+    return slot < 0 ? m_pixels + static_cast<size_t>(sourceY) * m_width
+                    : m_rows.data() + static_cast<size_t>(slot) * m_width;
+}
@@ -0,0 +1,32 @@
+#ifndef HALOROWS_H
+#define HALOROWS_H
+
+#include <cstdint>
+#include <vector>
+#include "Convolution.h"
+
+// Źródło wierszy dla splotu w miejscu. Każdy pas wątku idzie w dół i trzyma w buforze
+// cyklicznym wiersze okna jądra, więc wiersz zapisywany był już wcześniej wczytany. Zagrożone są
+// tylko wiersze przy granicach pasów (czyta je też sąsiedni pas) i przy brzegach obrazu (tryb brzegu
+// odwołuje się do już nadpisanych wierszy) - te radius + 1 wierszy z każdej strony granicy jest
+// kopiowanych przed startem. Dodatkowa pamięć O(pasy * k * width) zamiast kopii całego obrazu.
+//
+// Wymagania: pasy jak w Parallel::forBands(height, bands, ...), pas czyta wiersz y + radius
+// dopiero przed zapisem wiersza y.
+class HaloRows {
+public:
+    HaloRows(const uint32_t* pixels, int width, int height, int bands, int radius, Convolution::Border border);
+
+    // Wiersz y (może wychodzić poza obraz) w stanie sprzed splotu; nullptr oznacza wiersz zer (Constant)
+    const uint32_t* row(int y) const;
+
+private:
+    const uint32_t* m_pixels;
+    int m_width;
+    int m_height;
+    Convolution::Border m_border;
+    std::vector<int> m_slots; // indeks kopii dla wiersza obrazu, -1 - wiersz czytany z obrazu
+    std::vector<uint32_t> m_rows;
+};
+
+#endif // HALOROWS_H
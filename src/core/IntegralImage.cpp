@@ -0,0 +1,68 @@
+#include "IntegralImage.h"
+#include "Parallel.h"
+#include <limits>
+
+template <typename Sum>
+IntegralImage<Sum>::IntegralImage(const uint8_t* plane, int width, int height, Values values)
+    : m_width(width), m_height(height), m_stride(width + 1),
+      m_table(static_cast<size_t>(width + 1) * (height + 1), 0) {
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    bool squared = values == Values::Squared;
+    int bands = Parallel::bandCount(height, 64);
+
+    // Przebieg 1: każdy pas liczy sumy tak, jakby zaczynał się od zerowego wiersza
+    Parallel::forBands(height, bands, [&](int, int begin, int end) {
+        for (int y = begin; y < end; ++y) {
+            const uint8_t* row = plane + static_cast<size_t>(y) * width;
+            const Sum* above = m_table.data() + static_cast<size_t>(y) * m_stride;
+            Sum* out = m_table.data() + static_cast<size_t>(y + 1) * m_stride;
+            bool first = y == begin;
+            Sum rowSum = 0;
+            for (int x = 0; x < width; ++x) {
+                Sum value = row[x];
+                rowSum += squared ? value * value : value;
+                out[x + 1] = rowSum + (first ? 0 : above[x + 1]);
+            }
+        }
+    });
+    if (bands == 1) {
+        return;
+    }
+
+    // Przeniesienie: ostatni wiersz pasu plus przeniesienie wszystkich pasów powyżej (szeregowo, pasów jest mało)
+    std::vector<Sum> carries(static_cast<size_t>(bands) * m_stride, 0);
+    for (int band = 1; band < bands; ++band) {
+        int last = Parallel::bandBegin(height, bands, band);
+        const Sum* previous = carries.data() + static_cast<size_t>(band - 1) * m_stride;
+        const Sum* row = m_table.data() + static_cast<size_t>(last) * m_stride;
+        Sum* carry = carries.data() + static_cast<size_t>(band) * m_stride;
+        for (int x = 0; x < m_stride; ++x) {
+            carry[x] = previous[x] + row[x];
+        }
+    }
+
+    // Przebieg 2: dodanie przeniesienia do wierszy pasu
+    Parallel::forBands(height, bands, [&](int band, int begin, int end) {
+        if (band == 0) {
+            return;
+        }
+        const Sum* carry = carries.data() + static_cast<size_t>(band) * m_stride;
+        for (int y = begin; y < end; ++y) {
+            Sum* out = m_table.data() + static_cast<size_t>(y + 1) * m_stride;
+            for (int x = 0; x < m_stride; ++x) {
+                out[x] += carry[x];
+            }
+        }
+    });
+}
+
+template <typename Sum>
+bool IntegralImage<Sum>::fits(long long area, Values values) {
+    long double maxValue = values == Values::Squared ? 255.0L * 255.0L : 255.0L;
+    return area * maxValue <= static_cast<long double>(std::numeric_limits<Sum>::max());
+}
+
+template class IntegralImage<uint32_t>;
+template class IntegralImage<uint64_t>;
@@ -0,0 +1,50 @@
+#ifndef INTEGRALIMAGE_H
+#define INTEGRALIMAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Tablica sum prefiksowych (summed-area table) płaszczyzny 8-bit: suma dowolnego prostokąta
+// w O(1) - filtry pudełkowe, progowanie adaptacyjne, statystyki lokalne, średnie w ROI.
+// Tablica ma rozmiar (width + 1) x (height + 1) z zerowym pierwszym wierszem i kolumną.
+//
+// Akumulator Sum (uint32_t lub uint64_t) liczy modulo 2^bits, więc suma prostokąta jest dokładna,
+// dopóki ona sama (nie cała tablica) mieści się w typie: uint32_t wystarcza dla prostokątów do
+// 16.8 mln pikseli (wartości) lub 66 tys. pikseli (kwadraty) - zob. fits.
+//   IntegralImage<uint32_t> sums(gray.data(), width, height);
+//   uint32_t s = sums.rectSum(x0, y0, x1, y1);
+template <typename Sum>
+class IntegralImage {
+public:
+    enum class Values {
+        Plain,  // suma wartości
+        Squared // suma kwadratów wartości (wariancja lokalna)
+    };
+
+    IntegralImage() = default;
+
+    // Budowa równoległa: pasy wierszy liczą sumy lokalne, potem dodają przeniesienie z pasów wyżej
+    IntegralImage(const uint8_t* plane, int width, int height, Values values = Values::Plain);
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+
+    // Suma w prostokącie [x0, x1) x [y0, y1) (0 <= x0 <= x1 <= width, 0 <= y0 <= y1 <= height)
+    Sum rectSum(int x0, int y0, int x1, int y1) const {
+        const Sum* top = m_table.data() + static_cast<size_t>(y0) * m_stride;
+        const Sum* bottom = m_table.data() + static_cast<size_t>(y1) * m_stride;
+        return bottom[x1] - bottom[x0] - top[x1] + top[x0];
+    }
+
+    // Czy suma prostokąta o area pikselach zawsze mieści się w akumulatorze
+    static bool fits(long long area, Values values);
+
+private:
+    int m_width = 0;
+    int m_height = 0;
+    int m_stride = 0;
+    std::vector<Sum> m_table;
+};
+
+#endif // INTEGRALIMAGE_H
@@ -0,0 +1,45 @@
+#ifndef KERNEL_H
+#define KERNEL_H
+
+#include <cstddef>
+#include <vector>
+
+// Jądro splotu w płaskiej tablicy, wiersz po wierszu: weights[y * width + x].
+// Współczynnik (x, y) mnoży piksel przesunięty o (x - width / 2, y - height / 2);
+// jądro nie jest odwracane, jak we wszystkich filtrach programu.
+struct Kernel {
+    int width = 0;
+    int height = 0;
+    std::vector<double> weights;
+
+    Kernel() = default;
+
+    Kernel(int width, int height)
+        : width(width), height(height), weights(static_cast<size_t>(width) * height, 0.0) {}
+
+    // Z macierzy matrix[x][y] (generatory jąder i dialogi); macierz postrzępiona daje jądro puste
+    Kernel(const std::vector<std::vector<double>>& matrix) {
+        if (matrix.empty() || matrix[0].empty()) {
+            return;
+        }
+        for (const auto& column : matrix) {
+            if (column.size() != matrix[0].size()) {
+                return;
+            }
+        }
+        *this = Kernel(static_cast<int>(matrix.size()), static_cast<int>(matrix[0].size()));
+        for (int x = 0; x < width; ++x) {
+            for (int y = 0; y < height; ++y) {
+                at(x, y) = matrix[x][y];
+            }
+        }
+    }
+
+    double at(int x, int y) const { return weights[static_cast<size_t>(y) * width + x]; }
+    double& at(int x, int y) { return weights[static_cast<size_t>(y) * width + x]; }
+
+    // Wymiary nieparzyste - środek jądra leży na pikselu
+    bool isValid() const { return width > 0 && height > 0 && width % 2 == 1 && height % 2 == 1; }
+};
+
+#endif // KERNEL_H
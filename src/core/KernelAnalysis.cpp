@@ -0,0 +1,106 @@
+#include "KernelAnalysis.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+KernelAnalysis::Decomposition KernelAnalysis::decompose(const Kernel& kernel, double tolerance) {
+    Decomposition result;
+    int rows = kernel.width;
+    int columns = kernel.height;
+    if (rows == 0 || columns == 0) {
+        return result;
+    }
+
+    // Jednostronna metoda Jacobiego: obroty kolumn A aż staną się ortogonalne.
+    // Wtedy A = U * S * V^T, gdzie normy kolumn to wartości osobliwe.
+    std::vector<std::vector<double>> a(rows, std::vector<double>(columns));
+    for (int x = 0; x < rows; ++x) {
+        for (int y = 0; y < columns; ++y) {
+            a[x][y] = kernel.at(x, y);
+        }
+    }
+    std::vector<std::vector<double>> v(columns, std::vector<double>(columns, 0.0));
+    for (int i = 0; i < columns; ++i) {
+        v[i][i] = 1.0;
+    }
+
+    for (int sweep = 0; sweep < 60; ++sweep) {
+        bool rotated = false;
+        for (int p = 0; p < columns - 1; ++p) {
+            for (int q = p + 1; q < columns; ++q) {
+                double alpha = 0.0, beta = 0.0, gamma = 0.0;
+                for (int i = 0; i < rows; ++i) {
+                    alpha += a[i][p] * a[i][p];
+                    beta += a[i][q] * a[i][q];
+                    gamma += a[i][p] * a[i][q];
+                }
+                if (std::abs(gamma) <= 1e-15 * std::sqrt(alpha * beta) || gamma == 0.0) {
+                    continue;
+                }
+                rotated = true;
+                double zeta = (beta - alpha) / (2.0 * gamma);
+                double t = (zeta >= 0 ? 1.0 : -1.0) / (std::abs(zeta) + std::sqrt(1.0 + zeta * zeta));
+                double c = 1.0 / std::sqrt(1.0 + t * t);
+                double s = c * t;
+                for (int i = 0; i < rows; ++i) {
+                    double ap = a[i][p], aq = a[i][q];
+                    a[i][p] = c * ap - s * aq;
+                    a[i][q] = s * ap + c * aq;
+                }
+                for (int i = 0; i < columns; ++i) {
+                    double vp = v[i][p], vq = v[i][q];
+                    v[i][p] = c * vp - s * vq;
+                    v[i][q] = s * vp + c * vq;
+                }
+            }
+        }
+        if (!rotated) {
+            break;
+        }
+    }
+
+    std::vector<double> singular(columns);
+    for (int j = 0; j < columns; ++j) {
+        double norm = 0.0;
+        for (int i = 0; i < rows; ++i) {
+            norm += a[i][j] * a[i][j];
+        }
+        singular[j] = std::sqrt(norm);
+    }
+    std::vector<int> order(columns);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int l, int r) { return singular[l] > singular[r]; });
+
+    double largest = singular[order[0]];
+    if (largest == 0.0) {
+        return result;
+    }
+
+    // Składnik t: horizontal = S_t * U_t (kolumna A po obrotach), vertical = V_t
+    for (int j : order) {
+        if (singular[j] <= tolerance * largest) {
+            break;
+        }
+        SeparableTerm term;
+        term.horizontal.resize(rows);
+        term.vertical.resize(columns);
+        for (int i = 0; i < rows; ++i) {
+            term.horizontal[i] = a[i][j];
+        }
+        for (int i = 0; i < columns; ++i) {
+            term.vertical[i] = v[i][j];
+        }
+        result.terms.push_back(std::move(term));
+    }
+
+    for (int x = 0; x < rows; ++x) {
+        for (int y = 0; y < columns; ++y) {
+            double sum = 0.0;
+            for (const auto& term : result.terms) {
+                sum += term.horizontal[x] * term.vertical[y];
+            }
+            result.maxError = std::max(result.maxError, std::abs(sum - kernel.at(x, y)));
+        }
+    }
+    return result;
+}
@@ -0,0 +1,30 @@
+#ifndef KERNELANALYSIS_H
+#define KERNELANALYSIS_H
+
+#include <vector>
+#include "Kernel.h"
+
+// Rozkład jądra splotu 2D na sumę jąder separowalnych (SVD):
+// kernel(x, y) ≈ suma po składnikach horizontal[x] * vertical[y].
+// Jądro o rzędzie r można policzyć jako r par przebiegów 1D (2 * k * r mnożeń zamiast k²).
+class KernelAnalysis {
+public:
+    struct SeparableTerm {
+        std::vector<double> horizontal;
+        std::vector<double> vertical;
+    };
+
+    struct Decomposition {
+        std::vector<SeparableTerm> terms; // składniki od największej wartości osobliwej
+        double maxError = 0.0;            // maks. różnica między jądrem a sumą składników
+    };
+
+    // Wartości osobliwe mniejsze niż tolerance * największa są pomijane
+    static constexpr double DefaultTolerance = 1e-6;
+
+    // Rozkład jądra (kwadratowego lub prostokątnego)
+    static Decomposition decompose(const Kernel& kernel,
+                                   double tolerance = DefaultTolerance);
+};
+
+#endif // KERNELANALYSIS_H
@@ -0,0 +1,75 @@
+#include "Luma.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define LUMA_SSE2 1
+#endif
+
+#ifdef LUMA_SSE2
+namespace {
+
+// Luminancja czterech pikseli naraz: kanały B i R tworzą pary int16 w każdym słowie 32-bitowym,
+// więc dwa _mm_madd_epi16 liczą całą sumę ważoną. Wynik: cztery wartości 0-255 w int32.
+inline __m128i luma4(__m128i pixels, __m128i weightsBR, __m128i weightsG, __m128i rounding) {
+    const __m128i byteMask = _mm_set1_epi32(0x00FF00FF);
+    const __m128i lowMask = _mm_set1_epi32(0x000000FF);
+
+    __m128i br = _mm_and_si128(pixels, byteMask);
+    __m128i g = _mm_and_si128(_mm_srli_epi32(pixels, 8), lowMask);
+    __m128i sum = _mm_add_epi32(_mm_madd_epi16(br, weightsBR), _mm_madd_epi16(g, weightsG));
+    return _mm_srli_epi32(_mm_add_epi32(sum, rounding), Luma::Shift);
+}
+
+struct LumaConstants {
+    __m128i weightsBR;
+    __m128i weightsG;
+    __m128i rounding;
+
+    explicit LumaConstants(Luma::Weights weights) {
+        Luma::FixedWeights w = Luma::fixedWeights(weights);
+        weightsBR = _mm_set1_epi32((w.r << 16) | w.b);
+        weightsG = _mm_set1_epi32(w.g);
+        rounding = _mm_set1_epi32(1 << (Luma::Shift - 1));
+    }
+};
+
+} // namespace
+#endif
+
+void Luma::toGray(const uint32_t* src, uint8_t* dst, size_t count, Weights weights) {
+    size_t i = 0;
+
+#ifdef LUMA_SSE2
+    LumaConstants c(weights);
+    // 16 pikseli na iterację -> 16 bajtów wyniku
+    for (; i + 16 <= count; i += 16) {
+        const auto* in = reinterpret_cast<const __m128i*>(src + i);
+        __m128i y0 = luma4(_mm_loadu_si128(in + 0), c.weightsBR, c.weightsG, c.rounding);
+        __m128i y1 = luma4(_mm_loadu_si128(in + 1), c.weightsBR, c.weightsG, c.rounding);
+        __m128i y2 = luma4(_mm_loadu_si128(in + 2), c.weightsBR, c.weightsG, c.rounding);
+        __m128i y3 = luma4(_mm_loadu_si128(in + 3), c.weightsBR, c.weightsG, c.rounding);
+        __m128i lo = _mm_packs_epi32(y0, y1);
+        __m128i hi = _mm_packs_epi32(y2, y3);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        uint32_t p = src[i];
+        dst[i] = static_cast<uint8_t>(gray((p >> 16) & 0xFF, (p >> 8) & 0xFF, p & 0xFF, weights));
+    }
+}
+
+void Luma::toGrayF(const uint32_t* src, float* dst, size_t count, Weights weights) {
+    // Wagi Q14 podzielone przez 2^14 są dokładne w float - ta sama luminancja co toGray przed zaokrągleniem
+    FixedWeights w = fixedWeights(weights);
+    const float scale = 1.0f / (1 << Shift);
+    const float wr = w.r * scale;
+    const float wg = w.g * scale;
+    const float wb = w.b * scale;
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t p = src[i];
+        dst[i] = wr * static_cast<float>((p >> 16) & 0xFF) + wg * static_cast<float>((p >> 8) & 0xFF) +
+                 wb * static_cast<float>(p & 0xFF);
+    }
+}
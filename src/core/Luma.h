@@ -0,0 +1,56 @@
+#ifndef LUMA_H
+#define LUMA_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Wspólne jądro konwersji RGB -> luminancja w arytmetyce stałoprzecinkowej.
+// Piksele wejściowe mają układ QRgb (0xAARRGGBB), wagi są w formacie Q14 (suma = 1 << 14).
+class Luma {
+public:
+    // Dostępne zestawy wag
+    enum class Weights {
+        Legacy, // 0.3 / 0.6 / 0.1 - historyczne wagi programu
+        BT601,  // 0.299 / 0.587 / 0.114
+        BT709   // 0.2126 / 0.7152 / 0.0722
+    };
+
+    static constexpr int Shift = 14;
+
+    struct FixedWeights {
+        int r, g, b;
+    };
+
+    // Wagi Q14 zaokrąglone tak, aby ich suma wynosiła dokładnie 1 << 14 (biel pozostaje bielą)
+    static constexpr FixedWeights fixedWeights(Weights weights) {
+        switch (weights) {
+            case Weights::BT601:
+                return {4899, 9617, 1868};
+            case Weights::BT709:
+                return {3483, 11718, 1183};
+            case Weights::Legacy:
+            default:
+                return {4915, 9831, 1638};
+        }
+    }
+
+    // Luminancja pojedynczego piksela - wynik identyczny z wersją wektorową
+    static constexpr int gray(int r, int g, int b, Weights weights = Weights::Legacy) {
+        FixedWeights w = fixedWeights(weights);
+        return (r * w.r + g * w.g + b * w.b + (1 << (Shift - 1))) >> Shift;
+    }
+
+    // Luminancja dla wartości zmiennoprzecinkowych (np. wyników konwolucji) z tymi samymi wagami
+    static constexpr double grayF(double r, double g, double b, Weights weights = Weights::Legacy) {
+        FixedWeights w = fixedWeights(weights);
+        return (r * w.r + g * w.g + b * w.b) / (1 << Shift);
+    }
+
+    // Konwersja ciągu pikseli na jednokanałowy bufor luminancji
+    static void toGray(const uint32_t* src, uint8_t* dst, size_t count, Weights weights = Weights::Legacy);
+
+    // Jak toGray, ale bez zaokrąglania - wartości float 0-255 (płaszczyzny robocze łańcuchów operacji)
+    static void toGrayF(const uint32_t* src, float* dst, size_t count, Weights weights = Weights::Legacy);
+};
+
+#endif // LUMA_H
@@ -0,0 +1,50 @@
+#include "Parallel.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+int Parallel::threadCount() {
+    static const int count = std::max(1u, std::thread::hardware_concurrency());
+    return count;
+}
+
+int Parallel::bandCount(int count, int minPerBand) {
+    if (count <= 0) {
+        return 1;
+    }
+    int bands = count / std::max(1, minPerBand);
+    return std::clamp(bands, 1, threadCount());
+}
+
+int Parallel::bandBegin(int count, int bands, int band) {
+    return static_cast<int>(static_cast<long long>(count) * band / bands);
+}
+
+void Parallel::forRange(int count, const std::function<void(int, int)>& fn, int minPerBand) {
+    forBands(count, bandCount(count, minPerBand), [&fn](int, int begin, int end) {
+        fn(begin, end);
+    });
+}
+
+void Parallel::forBands(int count, int bands, const std::function<void(int, int, int)>& fn) {
+    if (count <= 0) {
+        return;
+    }
+    bands = std::clamp(bands, 1, count);
+    if (bands == 1) {
+        fn(0, 0, count);
+        return;
+    }
+
+    // Pas 0 wykonuje wątek wywołujący, pozostałe - wątki pomocnicze
+    std::vector<std::thread> workers;
+    workers.reserve(bands - 1);
+    for (int band = 1; band < bands; ++band) {
+        workers.emplace_back(fn, band, bandBegin(count, bands, band), bandBegin(count, bands, band + 1));
+    }
+    fn(0, 0, bandBegin(count, bands, 1));
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
@@ -0,0 +1,26 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <functional>
+
+// Prosty podział pracy na pasy (np. wierszy obrazu) wykonywane na osobnych wątkach.
+// Podział jest deterministyczny: dla tych samych argumentów pasy mają zawsze te same granice.
+class Parallel {
+public:
+    // Liczba wątków roboczych (liczba rdzeni, co najmniej 1)
+    static int threadCount();
+
+    // Liczba pasów, na które zostanie podzielony zakres o długości count
+    static int bandCount(int count, int minPerBand = 16);
+
+    // Początek pasa band z bands pasów pokrywających [0, count); bandBegin(count, bands, bands) == count
+    static int bandBegin(int count, int bands, int band);
+
+    // Wykonuje fn(begin, end) dla pasów pokrywających [0, count)
+    static void forRange(int count, const std::function<void(int, int)>& fn, int minPerBand = 16);
+
+    // Jak forRange, ale przekazuje też numer pasa (do buforów prywatnych dla pasa)
+    static void forBands(int count, int bands, const std::function<void(int, int, int)>& fn);
+};
+
+#endif // PARALLEL_H
@@ -0,0 +1,18 @@
+#include "Plane.h"
+
+Plane::Plane(int width, int height, float value)
+    : m_width(width), m_height(height), m_data(static_cast<size_t>(width) * height, value) {}
+
+Plane Plane::fromLuma(const uint32_t* pixels, int width, int height, Luma::Weights weights) {
+    Plane plane(width, height);
+    Luma::toGrayF(pixels, plane.data(), plane.size(), weights);
+    return plane;
+}
+
+Plane Plane::convolved(const Kernel& kernel, Convolution::Border border) const {
+    Plane result(m_width, m_height);
+    if (!empty()) {
+        Convolution::applyPlane(data(), result.data(), m_width, m_height, kernel, border);
+    }
+    return result;
+}
@@ -0,0 +1,43 @@
+#ifndef PLANE_H
+#define PLANE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Convolution.h"
+#include "Luma.h"
+
+// Jednokanałowa płaszczyzna robocza float32 (wiersz po wierszu) dla łańcuchów operacji, np.
+// szarość -> rozmycie -> gradienty w algorytmie Canny'ego. Kolejne kroki przekazują sobie
+// wartości float bez zapisu do obrazu, więc kwantyzacja do 8 bitów następuje tylko raz, na końcu.
+class Plane {
+public:
+    Plane() = default;
+    Plane(int width, int height, float value = 0.0f);
+
+    // Luminancja pikseli QRgb bez zaokrąglania do 0-255
+    static Plane fromLuma(const uint32_t* pixels, int width, int height,
+                          Luma::Weights weights = Luma::Weights::Legacy);
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    size_t size() const { return m_data.size(); }
+    bool empty() const { return m_data.empty(); }
+
+    float* data() { return m_data.data(); }
+    const float* data() const { return m_data.data(); }
+    float* row(int y) { return m_data.data() + static_cast<size_t>(y) * m_width; }
+    const float* row(int y) const { return m_data.data() + static_cast<size_t>(y) * m_width; }
+    float& at(int x, int y) { return m_data[static_cast<size_t>(y) * m_width + x]; }
+    float at(int x, int y) const { return m_data[static_cast<size_t>(y) * m_width + x]; }
+
+    // Splot silnikiem Convolution (ścieżka wg modelu kosztu), wynik w nowej płaszczyźnie
+    Plane convolved(const Kernel& kernel, Convolution::Border border = Convolution::Border::Replicate) const;
+
+private:
+    int m_width = 0;
+    int m_height = 0;
+    std::vector<float> m_data;
+};
+
+#endif // PLANE_H
@@ -0,0 +1,29 @@
+#include "PointOp.h"
+#include "Parallel.h"
+#include <cstddef>
+
+void PointOp::apply(uint32_t* pixels, int width, int height, const RowKernel& kernel) {
+    if (!pixels || width <= 0 || height <= 0) {
+        return;
+    }
+
+    // Pasy po co najmniej 64 wiersze - mniejsze obrazy nie opłaca się dzielić
+    Parallel::forRange(height, [&](int begin, int end) {
+        for (int y = begin; y < end; ++y) {
+            kernel(pixels + static_cast<size_t>(y) * width, width);
+        }
+    }, 64);
+}
+
+void PointOp::applyLUT(uint32_t* pixels, int width, int height,
+                       const uint8_t* lutR, const uint8_t* lutG, const uint8_t* lutB) {
+    apply(pixels, width, height, [lutR, lutG, lutB](uint32_t* row, int count) {
+        for (int x = 0; x < count; ++x) {
+            uint32_t p = row[x];
+            row[x] = (p & 0xFF000000u)
+                   | (static_cast<uint32_t>(lutR[(p >> 16) & 0xFF]) << 16)
+                   | (static_cast<uint32_t>(lutG[(p >> 8) & 0xFF]) << 8)
+                   | lutB[p & 0xFF];
+        }
+    });
+}
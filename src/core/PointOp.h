@@ -0,0 +1,21 @@
+#ifndef POINTOP_H
+#define POINTOP_H
+
+#include <cstdint>
+#include <functional>
+
+// Wspólna infrastruktura operacji punktowych na spakowanym buforze pikseli (QRgb, 0xAARRGGBB).
+// Jądro operacji dostaje cały wiersz, a wiersze są rozdzielane między wątki.
+class PointOp {
+public:
+    using RowKernel = std::function<void(uint32_t* row, int count)>;
+
+    // Zastosowanie jądra do każdego wiersza obrazu (w miejscu)
+    static void apply(uint32_t* pixels, int width, int height, const RowKernel& kernel);
+
+    // Zastosowanie osobnych tablic LUT do kanałów R, G i B
+    static void applyLUT(uint32_t* pixels, int width, int height,
+                         const uint8_t* lutR, const uint8_t* lutG, const uint8_t* lutB);
+};
+
+#endif // POINTOP_H
@@ -0,0 +1,159 @@
+#include "Pyramid.h"
+#include "Parallel.h"
+#include <algorithm>
+
+namespace {
+
+// Indeks odbity (dcb|abcd) - jak Convolution::Border::Reflect
+inline int reflect(int i, int n) {
+    return Convolution::borderIndex(i, n, Convolution::Border::Reflect);
+}
+
+// Bufory wierszy pasa wątku - przydzielane raz na pas, używane dla wszystkich jego wierszy
+struct RowScratch {
+    std::vector<float> line;
+    std::vector<float> even;
+    std::vector<float> odd;
+
+    explicit RowScratch(int size) : line(size), even(size / 2 + 3), odd(size / 2 + 3) {}
+};
+
+} // namespace
+
+Plane Pyramid::downsample(const Plane& plane) {
+    int width = plane.width();
+    int height = plane.height();
+    int outWidth = (width + 1) / 2;
+    int outHeight = (height + 1) / 2;
+    Plane result(outWidth, outHeight);
+    if (plane.empty()) {
+        return result;
+    }
+
+    Parallel::forRange(outHeight, [&](int begin, int end) {
+        RowScratch scratch(width + 4);
+        for (int y = begin; y < end; ++y) {
+            // Przebieg pionowy tylko dla zachowanego wiersza 2y - ciągła pętla po x (wektoryzowana)
+            const float* r0 = plane.row(reflect(2 * y - 2, height));
+            const float* r1 = plane.row(reflect(2 * y - 1, height));
+            const float* r2 = plane.row(reflect(2 * y, height));
+            const float* r3 = plane.row(reflect(2 * y + 1, height));
+            const float* r4 = plane.row(reflect(2 * y + 2, height));
+            float* line = scratch.line.data();
+            for (int x = 0; x < width; ++x) {
+                line[x] = r0[x] + 4.0f * (r1[x] + r3[x]) + 6.0f * r2[x] + r4[x];
+            }
+
+            // Kolumny parzyste i nieparzyste osobno (z brzegiem): even[i + 1] = line[2i], odd[i + 1] = line[2i + 1],
+            // wtedy wynik to pięć ciągłych tablic zamiast odczytów co drugi element
+            float* even = scratch.even.data();
+            float* odd = scratch.odd.data();
+            for (int i = -1; i <= outWidth; ++i) {
+                even[i + 1] = line[reflect(2 * i, width)];
+                odd[i + 1] = line[reflect(2 * i + 1, width)];
+            }
+            float* out = result.row(y);
+            for (int x = 0; x < outWidth; ++x) {
+                out[x] = (even[x] + 4.0f * (odd[x] + odd[x + 1]) + 6.0f * even[x + 1] + even[x + 2]) * (1.0f / 256.0f);
+            }
+        }
+    }, 8);
+    return result;
+}
+
+Plane Pyramid::upsample(const Plane& plane, int width, int height) {
+    Plane result(width, height);
+    int inWidth = plane.width();
+    int inHeight = plane.height();
+    if (plane.empty() || width <= 0 || height <= 0) {
+        return result;
+    }
+
+    Parallel::forRange(height, [&](int begin, int end) {
+        RowScratch scratch(2 * inWidth + 4);
+        for (int y = begin; y < end; ++y) {
+            // Wiersz parzysty: (1, 6, 1) / 8 wokół y / 2, nieparzysty: (4, 4) / 8 między sąsiadami
+            float* line = scratch.line.data();
+            int center = y / 2;
+            if (y % 2 == 0) {
+                const float* r0 = plane.row(reflect(center - 1, inHeight));
+                const float* r1 = plane.row(reflect(center, inHeight));
+                const float* r2 = plane.row(reflect(center + 1, inHeight));
+                for (int x = 0; x < inWidth; ++x) {
+                    line[x] = (r0[x] + 6.0f * r1[x] + r2[x]) * (1.0f / 8.0f);
+                }
+            } else {
+                const float* r0 = plane.row(reflect(center, inHeight));
+                const float* r1 = plane.row(reflect(center + 1, inHeight));
+                for (int x = 0; x < inWidth; ++x) {
+                    line[x] = (r0[x] + r1[x]) * 0.5f;
+                }
+            }
+
+            // To samo poziomo: kolumny parzyste i nieparzyste wyniku liczone ciągłymi pętlami
+            line[inWidth] = line[reflect(inWidth, inWidth)];
+            float* even = scratch.even.data();
+            float* odd = scratch.odd.data();
+            int pairs = (width + 1) / 2;
+            even[0] = (line[reflect(-1, inWidth)] + 6.0f * line[0] + line[1]) * (1.0f / 8.0f);
+            for (int i = 1; i < pairs; ++i) {
+                even[i] = (line[i - 1] + 6.0f * line[i] + line[i + 1]) * (1.0f / 8.0f);
+            }
+            for (int i = 0; i < pairs; ++i) {
+                odd[i] = (line[i] + line[i + 1]) * 0.5f;
+            }
+            float* out = result.row(y);
+            for (int i = 0; i < width / 2; ++i) {
+                out[2 * i] = even[i];
+                out[2 * i + 1] = odd[i];
+            }
+            if (width % 2) {
+                out[width - 1] = even[width / 2];
+            }
+        }
+    }, 16);
+    return result;
+}
+
+std::vector<Plane> Pyramid::gaussian(const Plane& base, int levels) {
+    std::vector<Plane> pyramid;
+    if (base.empty() || levels <= 0) {
+        return pyramid;
+    }
+    pyramid.reserve(levels);
+    pyramid.push_back(base);
+    while (static_cast<int>(pyramid.size()) < levels && (pyramid.back().width() > 1 || pyramid.back().height() > 1)) {
+        pyramid.push_back(downsample(pyramid.back()));
+    }
+    return pyramid;
+}
+
+std::vector<Plane> Pyramid::laplacian(const Plane& base, int levels) {
+    std::vector<Plane> pyramid = gaussian(base, levels);
+    // Od góry do dołu, w miejscu: poziom k staje się różnicą, k + 1 jest jeszcze poziomem Gaussa
+    for (size_t k = 0; k + 1 < pyramid.size(); ++k) {
+        Plane expanded = upsample(pyramid[k + 1], pyramid[k].width(), pyramid[k].height());
+        float* level = pyramid[k].data();
+        const float* values = expanded.data();
+        for (size_t i = 0; i < expanded.size(); ++i) {
+            level[i] -= values[i];
+        }
+    }
+    return pyramid;
+}
+
+Plane Pyramid::reconstruct(const std::vector<Plane>& laplacian) {
+    if (laplacian.empty()) {
+        return {};
+    }
+    Plane result = laplacian.back();
+    for (size_t k = laplacian.size() - 1; k-- > 0;) {
+        result = upsample(result, laplacian[k].width(), laplacian[k].height());
+        float* values = result.data();
+        const float* detail = laplacian[k].data();
+        for (size_t i = 0; i < result.size(); ++i) {
+            values[i] += detail[i];
+        }
+    }
+    return result;
+}
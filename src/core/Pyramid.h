@@ -0,0 +1,31 @@
+#ifndef PYRAMID_H
+#define PYRAMID_H
+
+#include <vector>
+#include "Plane.h"
+
+// Piramidy Gaussa i Laplace'a (Burt, Adelson) dla płaszczyzn float: przetwarzanie od zgrubnej
+// skali do dokładnej, podglądy, łączenie obrazów. Poziom k + 1 to poziom k rozmyty separowalnym
+// jądrem [1 4 6 4 1] / 16 i zdecymowany 2x (rozmiar (n + 1) / 2), brzeg odbity (dcb|abcd).
+// Rozmycie liczone jest tylko dla zachowanych wierszy i kolumn, więc każdy poziom kosztuje
+// 1/4 poprzedniego, a cała piramida ok. 4/3 pierwszego poziomu.
+class Pyramid {
+public:
+    // Jeden poziom w dół: rozmycie i decymacja
+    static Plane downsample(const Plane& plane);
+
+    // Powiększenie 2x do width x height (((width + 1) / 2, (height + 1) / 2) to rozmiar plane)
+    // tym samym jądrem z wagami x4 - odwrotność downsample dla poziomów piramidy Laplace'a
+    static Plane upsample(const Plane& plane, int width, int height);
+
+    // Poziomy 0 ... levels - 1 (poziom 0 to kopia base); mniej poziomów, gdy obraz zmaleje do 1 piksela
+    static std::vector<Plane> gaussian(const Plane& base, int levels);
+
+    // L_k = G_k - upsample(G_k+1), ostatni poziom to najmniejszy poziom piramidy Gaussa
+    static std::vector<Plane> laplacian(const Plane& base, int levels);
+
+    // Odtworzenie poziomu 0: G_k = L_k + upsample(G_k+1), od najmniejszego poziomu
+    static Plane reconstruct(const std::vector<Plane>& laplacian);
+};
+
+#endif // PYRAMID_H
@@ -0,0 +1,34 @@
+#include "StaticConvolution.h"
+#include <algorithm>
+
+namespace {
+
+template <typename Source, typename Sample>
+void loadRow(const Source* plane, int width, int height, int y, int left, Convolution::Border border, Sample* row) {
+    int count = width + 2 * left;
+    int sourceY = Convolution::borderIndex(y, height, border);
+    if (sourceY < 0) {
+        std::fill(row, row + count, Sample{});
+        return;
+    }
+    const Source* source = plane + static_cast<size_t>(sourceY) * width;
+    for (int i = 0; i < count; ++i) {
+        int x = i - left;
+        if (x < 0 || x >= width) {
+            x = Convolution::borderIndex(x, width, border);
+        }
+        row[i] = x < 0 ? Sample{} : static_cast<Sample>(source[x]);
+    }
+}
+
+} // namespace
+
+void StaticConvolution::loadPlaneRow(const uint8_t* plane, int width, int height, int y, int left,
+                                     Convolution::Border border, int16_t* row) {
+    loadRow(plane, width, height, y, left, border, row);
+}
+
+void StaticConvolution::loadPlaneRow(const float* plane, int width, int height, int y, int left,
+                                     Convolution::Border border, float* row) {
+    loadRow(plane, width, height, y, left, border, row);
+}
@@ -0,0 +1,238 @@
+#ifndef STATICCONVOLUTION_H
+#define STATICCONVOLUTION_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "Convolution.h"
+#include "HaloRows.h"
+#include "Parallel.h"
+
+// Stała maska całkowita znana w czasie kompilacji, weights[x][y] - ten sam układ co macierze
+// generatorów jąder (kernel[x][y]), środek w (Width / 2, Height / 2)
+template <int Width, int Height>
+struct Mask {
+    static constexpr int width = Width;
+    static constexpr int height = Height;
+    int weights[Width][Height];
+
+    // Macierz dla ogólnego silnika (dialogi, transformata Hougha)
+    std::vector<std::vector<double>> toMatrix() const {
+        std::vector<std::vector<double>> matrix(Width, std::vector<double>(Height));
+        for (int x = 0; x < Width; ++x) {
+            for (int y = 0; y < Height; ++y) {
+                matrix[x][y] = weights[x][y];
+            }
+        }
+        return matrix;
+    }
+};
+
+// Maski filtrów krawędzi programu
+namespace Masks {
+inline constexpr Mask<3, 3> Laplacian3{{{0, -1, 0}, {-1, 4, -1}, {0, -1, 0}}};
+inline constexpr Mask<5, 5> Laplacian5{{{0, 0, -1, 0, 0}, {0, -1, -2, -1, 0}, {-1, -2, 16, -2, -1},
+                                        {0, -1, -2, -1, 0}, {0, 0, -1, 0, 0}}};
+inline constexpr Mask<3, 3> LaplacianNegative3{{{0, 1, 0}, {1, -4, 1}, {0, 1, 0}}};
+inline constexpr Mask<5, 5> LaplacianNegative5{{{0, 0, 1, 0, 0}, {0, 1, 2, 1, 0}, {1, 2, -16, 2, 1},
+                                                {0, 1, 2, 1, 0}, {0, 0, 1, 0, 0}}};
+inline constexpr Mask<3, 3> SobelX{{{-1, 0, 1}, {-2, 0, 2}, {-1, 0, 1}}};
+inline constexpr Mask<3, 3> SobelY{{{-1, -2, -1}, {0, 0, 0}, {1, 2, 1}}};
+inline constexpr Mask<3, 3> PrewittX{{{-1, 0, 1}, {-1, 0, 1}, {-1, 0, 1}}};
+inline constexpr Mask<3, 3> PrewittY{{{-1, -1, -1}, {0, 0, 0}, {1, 1, 1}}};
+// Roberts 2x2 zapisany jako 3x3 z zerową ostatnią kolumną i wierszem (środek jak w masce 2x2)
+inline constexpr Mask<3, 3> RobertsX{{{1, 0, 0}, {0, -1, 0}, {0, 0, 0}}};
+inline constexpr Mask<3, 3> RobertsY{{{0, 1, 0}, {-1, 0, 0}, {0, 0, 0}}};
+} // namespace Masks
+
+// Splot ze stałą maską: pętla po współczynnikach rozwinięta w czasie kompilacji, zerowe
+// współczynniki pominięte, arytmetyka całkowita (kanały 8-bit, akumulator int32) lub float
+// dla płaszczyzn float.
+// Wynik identyczny z Convolution dla tych samych masek, ale bez planowania i pośrednich płaszczyzn.
+//   StaticConvolution::apply<Masks::Laplacian3>(pixels, width, height, Convolution::Output::Absolute);
+class StaticConvolution {
+public:
+    // Splot kanałów R, G, B (Output::Clamp lub Output::Absolute)
+    template <auto M>
+    static void apply(uint32_t* pixels, int width, int height, Convolution::Output output,
+                      Convolution::Border border = Convolution::Border::Replicate) {
+        if (output == Convolution::Output::Absolute) {
+            run<M>(pixels, width, height, border, [](int value) { return std::abs(value); });
+        } else {
+            run<M>(pixels, width, height, border, [](int value) { return value; });
+        }
+    }
+
+    // Moduł gradientu sqrt(gx² + gy²) dla każdego kanału; maski muszą mieć ten sam rozmiar
+    template <auto MX, auto MY>
+    static void applyMagnitude(uint32_t* pixels, int width, int height,
+                               Convolution::Border border = Convolution::Border::Replicate) {
+        static_assert(MX.width == MY.width && MX.height == MY.height, "Maski gradientu muszą mieć ten sam rozmiar");
+        run<MX, MY>(pixels, width, height, border, [](int gx, int gy) {
+            float magnitude = std::sqrt(static_cast<float>(gx * gx + gy * gy));
+            return static_cast<int>(magnitude + 0.5f);
+        });
+    }
+
+    // Splot płaszczyzny 8-bit do wyniku całkowitego bez obcinania
+    template <auto M>
+    static void applyPlane(const uint8_t* src, int32_t* dst, int width, int height,
+                           Convolution::Border border = Convolution::Border::Replicate) {
+        runPlane<M, int16_t>(src, dst, width, height, border);
+    }
+
+    // Splot płaszczyzny float bez obcinania (np. gradienty Canny'ego na rozmytej luminancji)
+    template <auto M>
+    static void applyPlane(const float* src, float* dst, int width, int height,
+                           Convolution::Border border = Convolution::Border::Replicate) {
+        runPlane<M, float>(src, dst, width, height, border);
+    }
+
+private:
+    // Jeden współczynnik: zero znika w czasie kompilacji; Acc - typ akumulatora
+    template <auto M, int I, typename Acc, typename T>
+    static Acc tap(const T* const* rows, int x) {
+        constexpr int kx = I / M.height;
+        constexpr int ky = I % M.height;
+        constexpr int weight = M.weights[kx][ky];
+        if constexpr (weight == 0) {
+            return Acc{};
+        } else if constexpr (weight == 1) {
+            return static_cast<Acc>(rows[ky][x + kx]);
+        } else if constexpr (weight == -1) {
+            return -static_cast<Acc>(rows[ky][x + kx]);
+        } else {
+            return static_cast<Acc>(weight) * static_cast<Acc>(rows[ky][x + kx]);
+        }
+    }
+
+    // Suma po wszystkich współczynnikach maski dla piksela x (wiersze z uzupełnionym brzegiem)
+    template <auto M, typename Acc, typename T>
+    static Acc sum(const T* const* rows, int x) {
+        return [&]<int... I>(std::integer_sequence<int, I...>) {
+            return (tap<M, I, Acc>(rows, x) + ... + Acc{});
+        }(std::make_integer_sequence<int, M.width * M.height>{});
+    }
+
+    // Cały wiersz wyniku - prosta pętla po x, którą kompilator wektoryzuje
+    template <auto M, typename T, typename Out>
+    static void sumRow(const T* const* rows, Out* out, int width) {
+        const T* local[M.height];
+        for (int ky = 0; ky < M.height; ++ky) {
+            local[ky] = rows[ky];
+        }
+        for (int x = 0; x < width; ++x) {
+            out[x] = sum<M, Out>(local, x);
+        }
+    }
+
+    // Cykliczny bufor Height wierszy z uzupełnionym brzegiem dla każdego kanału: przy przejściu
+    // do następnego wiersza wyniku wczytywany jest tylko jeden nowy wiersz źródła
+    template <int Height, typename T = int16_t>
+    class RowRing {
+    public:
+        RowRing(int channels, int paddedWidth)
+            : m_paddedWidth(paddedWidth), m_buffer(static_cast<size_t>(channels) * Height * paddedWidth) {}
+
+        // Miejsce na wiersz źródła y (y może wychodzić poza obraz)
+        T* slot(int channel, int y) {
+            int index = (y % Height + Height) % Height;
+            return m_buffer.data() + static_cast<size_t>(channel * Height + index) * m_paddedWidth;
+        }
+
+        // Wiersze y - Height / 2 ... y + Height / 2
+        void window(int channel, int y, const T** rows) {
+            for (int ky = 0; ky < Height; ++ky) {
+                rows[ky] = slot(channel, y + ky - Height / 2);
+            }
+        }
+
+    private:
+        int m_paddedWidth;
+        std::vector<T> m_buffer;
+    };
+
+    // Wspólny przebieg dla płaszczyzn: Sample - typ wierszy w buforze, Out - typ wyniku i akumulatora
+    template <auto M, typename Sample, typename Source, typename Out>
+    static void runPlane(const Source* src, Out* dst, int width, int height, Convolution::Border border) {
+        constexpr int W = M.width;
+        constexpr int H = M.height;
+        int paddedWidth = width + W - 1;
+
+        Parallel::forRange(height, [&](int begin, int end) {
+            RowRing<H, Sample> ring(1, paddedWidth);
+            for (int y = begin - H / 2; y < begin + H / 2; ++y) {
+                loadPlaneRow(src, width, height, y, W / 2, border, ring.slot(0, y));
+            }
+            for (int y = begin; y < end; ++y) {
+                loadPlaneRow(src, width, height, y + H / 2, W / 2, border, ring.slot(0, y + H / 2));
+                const Sample* rows[H];
+                ring.window(0, y, rows);
+                sumRow<M>(rows, dst + static_cast<size_t>(y) * width, width);
+            }
+        }, 16);
+    }
+
+    // Wspólny przebieg dla spakowanych pikseli: dla każdego kanału wiersze sum wszystkich masek,
+    // potem finish(suma maski 1, suma maski 2, ...) daje wartość kanału przed obcięciem
+    template <auto M, auto... Rest, typename Finish>
+    static void run(uint32_t* pixels, int width, int height, Convolution::Border border, Finish finish) {
+        constexpr int W = M.width;
+        constexpr int H = M.height;
+        constexpr int Count = 1 + sizeof...(Rest);
+        if (width <= 0 || height <= 0) {
+            return;
+        }
+        int paddedWidth = width + W - 1;
+        // Wynik zapisywany w miejscu - kopiowane są tylko wiersze przy granicach pasów
+        int bands = Parallel::bandCount(height, 16);
+        HaloRows source(pixels, width, height, bands, H / 2, border);
+
+        Parallel::forBands(height, bands, [&](int, int begin, int end) {
+            RowRing<H> ring(3, paddedWidth);
+            auto load = [&](int y) {
+                int16_t* channels[3] = {ring.slot(0, y), ring.slot(1, y), ring.slot(2, y)};
+                Convolution::loadPixelRow(source.row(y), width, W / 2, border, channels);
+            };
+            for (int y = begin - H / 2; y < begin + H / 2; ++y) {
+                load(y);
+            }
+
+            std::vector<int32_t> sums(static_cast<size_t>(Count) * width);
+            for (int y = begin; y < end; ++y) {
+                load(y + H / 2);
+                uint32_t* out = pixels + static_cast<size_t>(y) * width;
+                for (int x = 0; x < width; ++x) {
+                    out[x] &= 0xFF000000u;
+                }
+                for (int c = 0; c < 3; ++c) {
+                    const int16_t* rows[H];
+                    ring.window(c, y, rows);
+                    [&]<int... I>(std::integer_sequence<int, I...>) {
+                        constexpr auto masks = std::make_tuple(M, Rest...);
+                        (sumRow<std::get<I>(masks)>(rows, sums.data() + static_cast<size_t>(I) * width, width), ...);
+                        int shift = 16 - 8 * c;
+                        for (int x = 0; x < width; ++x) {
+                            out[x] |= toChannel(finish(sums[static_cast<size_t>(I) * width + x]...)) << shift;
+                        }
+                    }(std::make_integer_sequence<int, Count>{});
+                }
+            }
+        });
+    }
+
+    static uint32_t toChannel(int value) {
+        return static_cast<uint32_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+    }
+
+    // Jak Convolution::loadPixelRow dla płaszczyzny 8-bit i float
+    static void loadPlaneRow(const uint8_t* plane, int width, int height, int y, int left,
+                             Convolution::Border border, int16_t* row);
+    static void loadPlaneRow(const float* plane, int width, int height, int y, int left,
+                             Convolution::Border border, float* row);
+};
+
+#endif // STATICCONVOLUTION_H
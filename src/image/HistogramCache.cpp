@@ -0,0 +1,172 @@
+#include "HistogramCache.h"
+#include "Image.h"
+#include "../core/Luma.h"
+#include "../core/Parallel.h"
+#include <algorithm>
+
+namespace {
+
+// Liczba przeplatanych podhistogramów na kanał: kolejne piksele trafiają do różnych tablic,
+// więc powtarzające się wartości nie czekają na zapis poprzedniej inkrementacji tego samego licznika
+constexpr int Lanes = 4;
+
+} // namespace
+
+bool HistogramCache::isSynced(uint64_t generation, int width, int height) const {
+    return m_generation == generation && m_width == width && m_height == height;
+}
+
+bool HistogramCache::isCurrent(const Image& image) const {
+    if (!isSynced(image.generation(), image.width(), image.height())) {
+        return false;
+    }
+    for (size_t tile = 0; tile < m_dirty.size(); ++tile) {
+        if (m_dirty[tile] || m_lumaStale[tile]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void HistogramCache::reset(int width, int height, uint64_t generation) {
+    m_width = width;
+    m_height = height;
+    m_tilesX = (width + TileSize - 1) / TileSize;
+    m_tilesY = (height + TileSize - 1) / TileSize;
+    size_t tiles = static_cast<size_t>(m_tilesX) * m_tilesY;
+
+    m_bins.assign(tiles * Bins, 0);
+    m_dirty.assign(tiles, 1);
+    m_lumaStale.assign(tiles, 0);
+    m_grey.assign(tiles, 0);
+    m_generation = generation;
+}
+
+void HistogramCache::pixelChanged(int x, int y, uint64_t previousGeneration, uint64_t generation) {
+    if (m_generation != previousGeneration) {
+        return;
+    }
+    m_dirty[(y / TileSize) * m_tilesX + x / TileSize] = 1;
+    m_generation = generation;
+}
+
+void HistogramCache::remap(const uint8_t* lutR, const uint8_t* lutG, const uint8_t* lutB,
+                           uint64_t previousGeneration, uint64_t generation) {
+    if (m_generation != previousGeneration) {
+        return;
+    }
+
+    // Dla kafelków szarych ta sama tablica na wszystkich kanałach zachowuje R = G = B,
+    // a luminancja szarego piksela jest równa jego wartości
+    bool sameLut = std::equal(lutR, lutR + 256, lutG) && std::equal(lutR, lutR + 256, lutB);
+    const uint8_t* luts[3] = {lutR, lutG, lutB};
+    std::array<uint32_t, 256> remapped;
+
+    for (size_t tile = 0; tile < m_dirty.size(); ++tile) {
+        if (m_dirty[tile]) {
+            continue;
+        }
+        uint32_t* bins = &m_bins[tile * Bins];
+        for (int c = 0; c < 3; ++c) {
+            remapped.fill(0);
+            for (int i = 0; i < 256; ++i) {
+                remapped[luts[c][i]] += bins[c * 256 + i];
+            }
+            std::copy(remapped.begin(), remapped.end(), bins + c * 256);
+        }
+        if (m_grey[tile] && sameLut) {
+            std::copy(bins, bins + 256, bins + 3 * 256);
+        } else {
+            m_lumaStale[tile] = 1;
+            m_grey[tile] = 0;
+        }
+    }
+    m_generation = generation;
+}
+
+void HistogramCache::countTile(const Image& image, int tile) {
+    int x0 = (tile % m_tilesX) * TileSize;
+    int y0 = (tile / m_tilesX) * TileSize;
+    int x1 = std::min(x0 + TileSize, m_width);
+    int y1 = std::min(y0 + TileSize, m_height);
+    int width = x1 - x0;
+
+    std::vector<uint32_t> counts(Lanes * Bins, 0);
+    std::vector<uint8_t> gray(width);
+    uint32_t* red = counts.data();
+    uint32_t* green = red + Lanes * 256;
+    uint32_t* blue = green + Lanes * 256;
+    uint32_t* luminance = blue + Lanes * 256;
+    uint32_t colorBits = 0;
+
+    for (int y = y0; y < y1; ++y) {
+        const QRgb* line = image.constScanLine(y) + x0;
+        Luma::toGray(line, gray.data(), width);
+
+        int x = 0;
+        for (; x + Lanes <= width; x += Lanes) {
+            for (int lane = 0; lane < Lanes; ++lane) {
+                QRgb p = line[x + lane];
+                int offset = lane * 256;
+                red[offset + ((p >> 16) & 0xFF)]++;
+                green[offset + ((p >> 8) & 0xFF)]++;
+                blue[offset + (p & 0xFF)]++;
+                luminance[offset + gray[x + lane]]++;
+                colorBits |= (p ^ (p >> 8)) & 0xFFFF;
+            }
+        }
+        for (; x < width; ++x) {
+            QRgb p = line[x];
+            red[(p >> 16) & 0xFF]++;
+            green[(p >> 8) & 0xFF]++;
+            blue[p & 0xFF]++;
+            luminance[gray[x]]++;
+            colorBits |= (p ^ (p >> 8)) & 0xFFFF;
+        }
+    }
+
+    // Scalanie podhistogramów do liczników kafelka
+    uint32_t* bins = &m_bins[static_cast<size_t>(tile) * Bins];
+    for (int c = 0; c < 4; ++c) {
+        const uint32_t* channel = counts.data() + c * Lanes * 256;
+        for (int i = 0; i < 256; ++i) {
+            uint32_t sum = 0;
+            for (int lane = 0; lane < Lanes; ++lane) {
+                sum += channel[lane * 256 + i];
+            }
+            bins[c * 256 + i] = sum;
+        }
+    }
+    m_dirty[tile] = 0;
+    m_lumaStale[tile] = 0;
+    m_grey[tile] = colorBits == 0;
+}
+
+HistogramCache::Totals HistogramCache::totals(const Image& image, bool parallel) {
+    if (!isSynced(image.generation(), image.width(), image.height())) {
+        reset(image.width(), image.height(), image.generation());
+    }
+
+    // Zliczane są tylko kafelki zmienione od ostatniego zapytania
+    std::vector<int> stale;
+    for (size_t tile = 0; tile < m_dirty.size(); ++tile) {
+        if (m_dirty[tile] || m_lumaStale[tile]) {
+            stale.push_back(static_cast<int>(tile));
+        }
+    }
+    int bands = parallel ? Parallel::bandCount(static_cast<int>(stale.size()), 1) : 1;
+    Parallel::forBands(static_cast<int>(stale.size()), bands, [&](int, int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            countTile(image, stale[i]);
+        }
+    });
+
+    Totals result{};
+    for (size_t tile = 0; tile < m_dirty.size(); ++tile) {
+        const uint32_t* bins = &m_bins[tile * Bins];
+        for (int i = 0; i < Bins; ++i) {
+            result[i] += bins[i];
+        }
+    }
+    return result;
+}
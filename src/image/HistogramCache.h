@@ -0,0 +1,54 @@
+#ifndef HISTOGRAMCACHE_H
+#define HISTOGRAMCACHE_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+class Image;
+
+// Histogramy (R, G, B, luminancja) zapamiętane przy obrazie, liczone osobno dla kafelków.
+// Cache jest zsynchronizowany z numerem modyfikacji obrazu (generation): zmiana pojedynczych
+// pikseli unieważnia tylko ich kafelki, operacje LUT przeliczają kosztem O(256) na kafelek,
+// a każdy inny zapis do bufora unieważnia całość.
+class HistogramCache {
+public:
+    static constexpr int TileSize = 256;
+    // Liczniki na kafelek: R, G, B i luminancja po 256 wartości
+    static constexpr int Bins = 4 * 256;
+
+    using Totals = std::array<uint32_t, Bins>;
+
+    // Czy cache odpowiada obrazowi o podanym numerze modyfikacji i rozmiarze
+    bool isSynced(uint64_t generation, int width, int height) const;
+
+    // Czy totals() dla tego obrazu nie musi niczego zliczać (tylko sumuje kafelki)
+    bool isCurrent(const Image& image) const;
+
+    // Zmiana piksela (x, y), po której obraz przeszedł z previousGeneration do generation
+    void pixelChanged(int x, int y, uint64_t previousGeneration, uint64_t generation);
+
+    // Zastosowanie LUT do całego obrazu - przemapowanie koszyków zamiast ponownego liczenia
+    void remap(const uint8_t* lutR, const uint8_t* lutG, const uint8_t* lutB,
+               uint64_t previousGeneration, uint64_t generation);
+
+    // Przelicza nieaktualne kafelki i zwraca sumaryczne histogramy obrazu
+    Totals totals(const Image& image, bool parallel);
+
+private:
+    int m_width = 0;
+    int m_height = 0;
+    int m_tilesX = 0;
+    int m_tilesY = 0;
+    uint64_t m_generation = UINT64_MAX;
+
+    std::vector<uint32_t> m_bins;      // Bins liczników na kafelek
+    std::vector<uint8_t> m_dirty;      // kafelek wymaga ponownego zliczenia
+    std::vector<uint8_t> m_lumaStale;  // R, G, B aktualne, luminancja nie
+    std::vector<uint8_t> m_grey;       // wszystkie piksele kafelka mają R = G = B
+
+    void reset(int width, int height, uint64_t generation);
+    void countTile(const Image& image, int tile);
+};
+
+#endif // HISTOGRAMCACHE_H
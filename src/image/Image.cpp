@@ -1,47 +1,99 @@
 #include "Image.h"
+#include "../core/PointOp.h"
+#include <atomic>
+#include <cstring>
 
 Image::Image(int width, int height) : m_width(width), m_height(height) {
-  m_pixels.resize(width * height, QColor());
+  m_pixels->resize(static_cast<size_t>(width) * height, qRgb(0, 0, 0));
+}
+
+Image::Image(const Image& other)
+    : m_width(other.m_width), m_height(other.m_height), m_pixels(other.m_pixels),
+      m_generation(other.m_generation), m_histogramCache(other.m_histogramCache) {}
+
+Image& Image::operator=(const Image& other) {
+  m_width = other.m_width;
+  m_height = other.m_height;
+  m_pixels = other.m_pixels;
+  m_generation = other.m_generation;
+  m_id = nextId();
+  m_histogramCache = other.m_histogramCache;
+  return *this;
+}
+
+QRgb* Image::writablePixels() {
+  // Drugi właściciel (np. migawka histogramu w wątku roboczym) tylko czyta - przy use_count() == 1
+  // nikt inny nie może już uzyskać referencji, więc zapis w miejscu jest bezpieczny
+  if (m_pixels.use_count() > 1) {
+    m_pixels = std::make_shared<std::vector<QRgb>>(*m_pixels);
+  }
+  return m_pixels->data();
+}
+
+uint64_t Image::nextId() {
+  static std::atomic<uint64_t> counter{0};
+  return ++counter;
 }
 
 QColor Image::pixelAt(int x, int y) const {
   if (x < 0 || x >= m_width || y < 0 || y >= m_height) {
     return {0, 0, 0};
   }
-  return m_pixels[y * m_width + x];
+  return QColor((*m_pixels)[y * m_width + x]);
 }
 
 int Image::getPixelR(int x, int y) const {
-  return pixelAt(x, y).red();
+  if (x < 0 || x >= m_width || y < 0 || y >= m_height) {
+    return 0;
+  }
+  return qRed((*m_pixels)[y * m_width + x]);
 }
 
 int Image::getPixelG(int x, int y) const {
-  return pixelAt(x, y).green();
+  if (x < 0 || x >= m_width || y < 0 || y >= m_height) {
+    return 0;
+  }
+  return qGreen((*m_pixels)[y * m_width + x]);
 }
 
 int Image::getPixelB(int x, int y) const {
-  return pixelAt(x, y).blue();
+  if (x < 0 || x >= m_width || y < 0 || y >= m_height) {
+    return 0;
+  }
+  return qBlue((*m_pixels)[y * m_width + x]);
 }
 
 void Image::setPixel(int x, int y, int r, int g, int b) {
-  setPixel(x, y, QColor(r, g, b));
+  if (x < 0 || x >= m_width || y < 0 || y >= m_height) {
+    return;
+  }
+  writablePixels()[y * m_width + x] = qRgb(r, g, b);
+  ++m_generation;
+  m_histogramCache.pixelChanged(x, y, m_generation - 1, m_generation);
 }
 
 void Image::setPixel(int x, int y, const QColor& color) {
   if (x < 0 || x >= m_width || y < 0 || y >= m_height) {
     return;
   }
-  m_pixels[y * m_width + x] = color;
+  writablePixels()[y * m_width + x] = color.rgb();
+  ++m_generation;
+  m_histogramCache.pixelChanged(x, y, m_generation - 1, m_generation);
+}
+
+void Image::applyLUT(const uint8_t* lutR, const uint8_t* lutG, const uint8_t* lutB) {
+  PointOp::applyLUT(writablePixels(), m_width, m_height, lutR, lutG, lutB);
+  ++m_generation;
+  m_histogramCache.remap(lutR, lutG, lutB, m_generation - 1, m_generation);
 }
 
 
 QImage Image::toQImage() const {
   QImage image(m_width, m_height, QImage::Format_RGB32);
 
+  // Format_RGB32 ma ten sam układ co bufor pikseli, więc kopiujemy całe wiersze
   for (int y = 0; y < m_height; ++y) {
-    for (int x = 0; x < m_width; ++x) {
-      image.setPixelColor(x, y, pixelAt(x, y));
-    }
+    std::memcpy(image.scanLine(y), constScanLine(y), static_cast<size_t>(m_width) * sizeof(QRgb));
   }
 
   return image;
@@ -4,16 +4,37 @@
 
 #ifndef IMAGE_H
 #define IMAGE_H
+#include <QColor>
 #include <QImage>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "HistogramCache.h"
 
 class Image {
 protected:
     int m_width = 0;
     int m_height = 0;
-    std::vector<QColor> m_pixels;
+    // Piksele spakowane jako QRgb (0xAARRGGBB), wiersz po wierszu. Bufor współdzielony z kopiami
+    // (kopiowanie przy zapisie): kopia obrazu tylko bierze referencję, a zapis do współdzielonego
+    // bufora najpierw go kopiuje.
+    std::shared_ptr<std::vector<QRgb>> m_pixels = std::make_shared<std::vector<QRgb>>();
+    // Numer modyfikacji - zwiększany przy każdym zapisie do bufora
+    uint64_t m_generation = 0;
+    // Identyfikator unikalny w procesie - numer modyfikacji sam nie odróżnia dwóch obrazów
+    uint64_t m_id = nextId();
+    mutable HistogramCache m_histogramCache;
+
+    static uint64_t nextId();
+
+    // Bufor do zapisu - własna kopia, jeśli bufor jest współdzielony
+    QRgb* writablePixels();
 public:
     Image() = default;
     Image(int width, int height);
+    // Kopia to osobny obraz z własnym identyfikatorem; piksele współdzielone do pierwszego zapisu
+    Image(const Image& other);
+    Image& operator=(const Image& other);
     virtual ~Image() = default;
 
     virtual bool load(const QString& filePath) = 0;
@@ -26,6 +47,22 @@ public:
     void setPixel(int x, int y, int r, int g, int b);
     void setPixel(int x, int y, const QColor& color);
 
+    // Bezpośredni dostęp do spakowanego bufora (dla szybkich operacji na całych wierszach).
+    // Wersje niestałe traktują obraz jako zmodyfikowany.
+    const QRgb* constBits() const { return m_pixels->data(); }
+    QRgb* bits() { ++m_generation; return writablePixels(); }
+    const QRgb* constScanLine(int y) const { return m_pixels->data() + static_cast<size_t>(y) * m_width; }
+    QRgb* scanLine(int y) { ++m_generation; return writablePixels() + static_cast<size_t>(y) * m_width; }
+    size_t pixelCount() const { return m_pixels->size(); }
+
+    // Operacja punktowa z osobnymi tablicami LUT dla kanałów; zapamiętane histogramy
+    // są przemapowywane zamiast liczone od nowa
+    void applyLUT(const uint8_t* lutR, const uint8_t* lutG, const uint8_t* lutB);
+
+    uint64_t generation() const { return m_generation; }
+    uint64_t id() const { return m_id; }
+    HistogramCache& histogramCache() const { return m_histogramCache; }
+
     QImage toQImage() const;
     int width() const { return m_width; }
     int height() const { return m_height; }
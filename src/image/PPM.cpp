@@ -46,7 +46,7 @@ bool PPM::load(const QString& filePath) {
     int maxValue = in.readLine().toInt();
 
     // Resize pixel storage
-    m_pixels.resize(m_width * m_height);
+    m_pixels = std::make_shared<std::vector<QRgb>>(static_cast<size_t>(m_width) * m_height);
 
     // Read pixel data
     for (int y = 0; y < m_height; ++y) {
@@ -0,0 +1,199 @@
+#include "Bilateral.h"
+#include "../core/Luma.h"
+#include "../core/Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Komórka siatki: suma R, G, B i liczba pikseli (współrzędne jednorodne)
+constexpr int Values = 4;
+// Margines siatki - jądro [1 4 6 4 1] i interpolacja nie wychodzą poza bufor
+constexpr int Padding = 2;
+
+struct Grid {
+    int width;  // x
+    int height; // y
+    int depth;  // luminancja
+    std::vector<float> cells;
+
+    float* cell(int x, int y, int z) {
+        return cells.data() + ((static_cast<size_t>(y) * width + x) * depth + z) * Values;
+    }
+};
+
+inline float luminance(QRgb pixel) {
+    return static_cast<float>(Luma::grayF(qRed(pixel), qGreen(pixel), qBlue(pixel)));
+}
+
+// Rozmycie [1 4 6 4 1] / 16 wzdłuż jednej osi siatki: lines linii po length komórek
+// odległych o stride floatów; line(i) zwraca początek linii i
+template <typename LineStart>
+void blurLines(int lines, int length, size_t stride, LineStart line) {
+    Parallel::forRange(lines, [&](int begin, int end) {
+        std::vector<float> copy(static_cast<size_t>(length + 2 * Padding) * Values, 0.0f);
+        for (int i = begin; i < end; ++i) {
+            float* data = line(i);
+            for (int k = 0; k < length; ++k) {
+                std::copy(data + k * stride, data + k * stride + Values, copy.data() + (k + Padding) * Values);
+            }
+            for (int k = 0; k < length; ++k) {
+                const float* c = copy.data() + (k + Padding) * Values;
+                float* out = data + k * stride;
+                for (int v = 0; v < Values; ++v) {
+                    out[v] = (c[v - 2 * Values] + 4.0f * c[v - Values] + 6.0f * c[v] + 4.0f * c[v + Values] +
+                              c[v + 2 * Values]) * (1.0f / 16.0f);
+                }
+            }
+        }
+    }, 1);
+}
+
+} // namespace
+
+void Bilateral::bilateralFilter(std::unique_ptr<Image>& image, double sigmaSpatial, double sigmaRange) {
+    if (!image || image->width() <= 0 || image->height() <= 0) {
+        return;
+    }
+    int width = image->width();
+    int height = image->height();
+    float spatial = static_cast<float>(std::max(sigmaSpatial, MinSigmaSpatial));
+    float range = static_cast<float>(std::max(sigmaRange, MinSigmaRange));
+
+    // Krok siatki równy sigmie - rozmycie siatki jądrem o sigmie ok. 1 komórki
+    // (współrzędne zaokrąglane przy rozrzucaniu - ostatnia komórka to round((n - 1) / sigma))
+    Grid grid;
+    grid.width = static_cast<int>((width - 1) / spatial + 0.5f) + 1 + 2 * Padding;
+    grid.depth = static_cast<int>(255.0f / range + 0.5f) + 1 + 2 * Padding;
+    int gridHeight = static_cast<int>((height - 1) / spatial + 0.5f) + 1 + 2 * Padding;
+
+    // Wiersz siatki dla każdego wiersza obrazu: komórka rozrzucenia i dolna komórka interpolacji
+    std::vector<int> splatRow(height);
+    std::vector<int> sliceRow(height);
+    for (int y = 0; y < height; ++y) {
+        splatRow[y] = static_cast<int>(y / spatial + 0.5f) + Padding;
+        sliceRow[y] = static_cast<int>(y / spatial + Padding);
+    }
+    auto firstRow = [](const std::vector<int>& rows, int gridRow) {
+        return static_cast<int>(std::lower_bound(rows.begin(), rows.end(), gridRow) - rows.begin());
+    };
+
+    // Siatka przetwarzana pasami wierszy: pas [a, b) jest kompletny po rozrzuceniu wierszy
+    // [a - Padding, b + Padding) i rozmyciu, kolejny pas zaczyna się od b - 1 (interpolacja
+    // sięga o komórkę w dół)
+    size_t rowCells = static_cast<size_t>(grid.width) * grid.depth;
+    int slabRows = std::max(MinSlabRows, static_cast<int>(MaxGridCells / rowCells) - 2 * Padding);
+    grid.cells.reserve(rowCells * std::min(slabRows + 2 * Padding, gridHeight) * Values);
+
+    QRgb* pixels = image->bits();
+    // Wiersze obrazu już zapisane wynikiem, a potrzebne do rozrzucenia w następnym pasie
+    std::vector<QRgb> saved;
+    int savedBegin = 0;
+    int savedEnd = 0;
+    auto sourceRow = [&](int y) -> const QRgb* {
+        if (y >= savedBegin && y < savedEnd) {
+            return saved.data() + static_cast<size_t>(y - savedBegin) * width;
+        }
+        return pixels + static_cast<size_t>(y) * width;
+    };
+
+    for (int a = 0;;) {
+        int b = std::min(a + slabRows, gridHeight);
+        bool last = b == gridHeight;
+        int lo = std::max(0, a - Padding);
+        int hi = std::min(gridHeight, b + Padding);
+        grid.height = hi - lo;
+        grid.cells.assign(rowCells * grid.height * Values, 0.0f);
+
+        // Rozrzucenie: pas wątku to zakres wierszy siatki, więc wątki nie piszą do tych samych komórek
+        Parallel::forRange(grid.height, [&](int begin, int end) {
+            int yEnd = firstRow(splatRow, lo + end);
+            for (int y = firstRow(splatRow, lo + begin); y < yEnd; ++y) {
+                int gy = splatRow[y] - lo;
+                const QRgb* row = sourceRow(y);
+                for (int x = 0; x < width; ++x) {
+                    QRgb p = row[x];
+                    int gx = static_cast<int>(x / spatial + 0.5f) + Padding;
+                    int gz = static_cast<int>(luminance(p) / range + 0.5f) + Padding;
+                    float* cell = grid.cell(gx, gy, gz);
+                    cell[0] += qRed(p);
+                    cell[1] += qGreen(p);
+                    cell[2] += qBlue(p);
+                    cell[3] += 1.0f;
+                }
+            }
+        }, 1);
+
+        // Separowalne rozmycie siatki wzdłuż z, x i y
+        size_t zStride = Values;
+        size_t xStride = static_cast<size_t>(grid.depth) * Values;
+        size_t yStride = static_cast<size_t>(grid.width) * xStride;
+        blurLines(grid.width * grid.height, grid.depth, zStride, [&](int i) {
+            return grid.cells.data() + static_cast<size_t>(i) * xStride;
+        });
+        blurLines(grid.height * grid.depth, grid.width, xStride, [&](int i) {
+            return grid.cells.data() + static_cast<size_t>(i / grid.depth) * yStride + (i % grid.depth) * zStride;
+        });
+        blurLines(grid.width * grid.depth, grid.height, yStride, [&](int i) {
+            return grid.cells.data() + static_cast<size_t>(i / grid.depth) * xStride + (i % grid.depth) * zStride;
+        });
+
+        // Wiersze obrazu odczytywane z tego pasa
+        int sliceBegin = firstRow(sliceRow, a);
+        int sliceEnd = last ? height : firstRow(sliceRow, b - 1);
+        if (!last) {
+            // Następny pas rozrzuca też wiersze, które ten pas zaraz nadpisze - kopia przed zapisem
+            int nextBegin = firstRow(splatRow, std::max(0, b - 1 - Padding));
+            std::vector<QRgb> copy;
+            for (int y = nextBegin; y < sliceEnd; ++y) {
+                const QRgb* row = sourceRow(y);
+                copy.insert(copy.end(), row, row + width);
+            }
+            saved.swap(copy);
+            savedBegin = nextBegin;
+            savedEnd = std::max(nextBegin, sliceEnd);
+        }
+
+        // Odczyt: interpolacja trójliniowa w punkcie piksela, wynik = suma kolorów / suma wag
+        Parallel::forRange(sliceEnd - sliceBegin, [&](int begin, int end) {
+            for (int y = sliceBegin + begin; y < sliceBegin + end; ++y) {
+                float fy = y / spatial + Padding;
+                int y0 = sliceRow[y] - lo;
+                float ty = fy - sliceRow[y];
+                QRgb* row = pixels + static_cast<size_t>(y) * width;
+                for (int x = 0; x < width; ++x) {
+                    float fx = x / spatial + Padding;
+                    float fz = luminance(row[x]) / range + Padding;
+                    int x0 = static_cast<int>(fx);
+                    int z0 = static_cast<int>(fz);
+                    float tx = fx - x0;
+                    float tz = fz - z0;
+
+                    float sum[Values] = {};
+                    for (int dy = 0; dy < 2; ++dy) {
+                        for (int dx = 0; dx < 2; ++dx) {
+                            float w = (dy ? ty : 1.0f - ty) * (dx ? tx : 1.0f - tx);
+                            const float* c0 = grid.cell(x0 + dx, y0 + dy, z0);
+                            const float* c1 = c0 + Values;
+                            for (int v = 0; v < Values; ++v) {
+                                sum[v] += w * ((1.0f - tz) * c0[v] + tz * c1[v]);
+                            }
+                        }
+                    }
+                    if (sum[3] > 0.0f) {
+                        float scale = 1.0f / sum[3];
+                        row[x] = qRgba(std::clamp(static_cast<int>(sum[0] * scale + 0.5f), 0, 255),
+                                       std::clamp(static_cast<int>(sum[1] * scale + 0.5f), 0, 255),
+                                       std::clamp(static_cast<int>(sum[2] * scale + 0.5f), 0, 255), qAlpha(row[x]));
+                    }
+                }
+            }
+        });
+
+        if (last) {
+            break;
+        }
+        a = b - 1;
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef BILATERAL_H
+#define BILATERAL_H
+
+#include <cstddef>
+#include <memory>
+#include "../image/Image.h"
+
+class Bilateral {
+public:
+    // Filtr bilateralny (wygładzanie z zachowaniem krawędzi) metodą siatki bilateralnej
+    // (Chen, Paris, Durand): piksele rozrzucane są do zmniejszonej siatki 3D (x / sigmaSpatial,
+    // y / sigmaSpatial, luminancja / sigmaRange), siatka rozmywana separowalnie jądrem [1 4 6 4 1],
+    // a wynik odczytywany interpolacją trójliniową. Rozmiar siatki maleje z sigmaSpatial, więc czas
+    // jest praktycznie niezależny od promienia. Wagi zakresu liczone z luminancji - wszystkie
+    // kanały zachowują te same krawędzie (krawędzie o tej samej jasności, a innym kolorze, są rozmywane).
+    static void bilateralFilter(std::unique_ptr<Image>& image, double sigmaSpatial, double sigmaRange);
+
+    // Mniejsze sigmy dają siatkę bliską rozdzielczości obrazu (liczba komórek rośnie jak
+    // 1 / (sigmaSpatial² * sigmaRange))
+    static constexpr double MinSigmaSpatial = 4.0;
+    static constexpr double MinSigmaRange = 5.0;
+
+    // Siatka przetwarzana jest pasami wierszy (wynik taki jak dla całej siatki), pas ma do MaxGridCells
+    // komórek po 16 B - najwyżej 64 MB. Pas ma co najmniej MinSlabRows + 4 wierszy siatki, więc dla
+    // obrazów szerszych niż ok. 25000 px (przy minimalnych sigmach) pamięć to ok. 2.7 KB na kolumnę obrazu.
+    static constexpr size_t MaxGridCells = size_t{1} << 22;
+    static constexpr int MinSlabRows = 8;
+};
+
+#endif // BILATERAL_H
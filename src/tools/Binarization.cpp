@@ -1,4 +1,8 @@
 #include "Binarization.h"
+#include "Histogram.h"
+#include "../core/IntegralImage.h"
+#include "../core/Luma.h"
+#include "../core/Parallel.h"
 #include <algorithm>
 #include <vector>
 #include <cmath>
@@ -12,23 +16,18 @@ void Binarization::thresholdBinarization(std::unique_ptr<Image>& image, int thre
     int width = image->width();
     int height = image->height();
     
+    std::vector<uint8_t> gray(width);
     for (int y = 0; y < height; ++y) {
+        QRgb* line = image->scanLine(y);
+        // Luminancja całego wiersza tym samym jądrem co w Greyscale
+        Luma::toGray(line, gray.data(), width);
         for (int x = 0; x < width; ++x) {
-            int r = image->getPixelR(x, y);
-            int g = image->getPixelG(x, y);
-            int b = image->getPixelB(x, y);
-            
-            int binaryValue = (rgbToGray(r, g, b) > threshold) ? 255 : 0;
-            image->setPixel(x, y, binaryValue, binaryValue, binaryValue);
+            int binaryValue = (gray[x] > threshold) ? 255 : 0;
+            line[x] = qRgb(binaryValue, binaryValue, binaryValue);
         }
     }
 }
 
-int Binarization::rgbToGray(int r, int g, int b) {
-    // z Greyscale.cpp
-    return static_cast<int>(0.3 * r + 0.6 * g + 0.1 * b);
-}
-
 void Binarization::otsuBinarization(std::unique_ptr<Image>& image) {
     if (!image) return;
     
@@ -42,24 +41,59 @@ void Binarization::otsuBinarization(std::unique_ptr<Image>& image) {
     thresholdBinarization(image, threshold);
 }
 
-std::vector<int> Binarization::calculateHistogram(std::unique_ptr<Image>& image) {
-    std::vector<int> histogram(256, 0);
+namespace {
+
+// Progowanie Sauvoli dla danego akumulatora sum kwadratów (uint32_t dla małych okien)
+template <typename SquaredSum>
+void sauvolaThreshold(const std::vector<uint8_t>& gray, QRgb* pixels, int width, int height, int radius, double k) {
+    IntegralImage<uint32_t> sums(gray.data(), width, height);
+    IntegralImage<SquaredSum> squares(gray.data(), width, height, IntegralImage<SquaredSum>::Values::Squared);
+    
+    Parallel::forRange(height, [&](int begin, int end) {
+        for (int y = begin; y < end; ++y) {
+            int y0 = std::max(0, y - radius);
+            int y1 = std::min(height, y + radius + 1);
+            QRgb* line = pixels + static_cast<size_t>(y) * width;
+            const uint8_t* values = gray.data() + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; ++x) {
+                int x0 = std::max(0, x - radius);
+                int x1 = std::min(width, x + radius + 1);
+                double area = static_cast<double>(x1 - x0) * (y1 - y0);
+                double mean = sums.rectSum(x0, y0, x1, y1) / area;
+                double variance = std::max(0.0, squares.rectSum(x0, y0, x1, y1) / area - mean * mean);
+                double threshold = mean * (1.0 + k * (std::sqrt(variance) / 128.0 - 1.0));
+                int binaryValue = values[x] > threshold ? 255 : 0;
+                line[x] = qRgb(binaryValue, binaryValue, binaryValue);
+            }
+        }
+    });
+}
+
+} // namespace
+
+void Binarization::sauvolaBinarization(std::unique_ptr<Image>& image, int windowSize, double k) {
+    if (!image || windowSize < 1) return;
     
     int width = image->width();
     int height = image->height();
+    int radius = windowSize / 2;
     
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            int r = image->getPixelR(x, y);
-            int g = image->getPixelG(x, y);
-            int b = image->getPixelB(x, y);
-            
-            int gray = rgbToGray(r, g, b);
-            histogram[gray]++;
-        }
-    }
+    // Luminancja tymi samymi wagami co przy progowaniu globalnym
+    std::vector<uint8_t> gray(image->pixelCount());
+    Luma::toGray(image->constBits(), gray.data(), gray.size());
     
-    return histogram;
+    long long area = static_cast<long long>(2 * radius + 1) * (2 * radius + 1);
+    if (IntegralImage<uint32_t>::fits(area, IntegralImage<uint32_t>::Values::Squared)) {
+        sauvolaThreshold<uint32_t>(gray, image->bits(), width, height, radius, k);
+    } else {
+        sauvolaThreshold<uint64_t>(gray, image->bits(), width, height, radius, k);
+    }
+}
+
+std::vector<int> Binarization::calculateHistogram(std::unique_ptr<Image>& image) {
+    // Histogram luminancji liczony równolegle (te same wagi co przy progowaniu)
+    auto histogram = Histogram::calculateHistogram(image, Histogram::Channel::LUMINANCE);
+    return {histogram.begin(), histogram.end()};
 }
 
 int Binarization::findOtsuThreshold(const std::vector<int>& histogram) {
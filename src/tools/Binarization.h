@@ -12,10 +12,12 @@ public:
     // Binaryzacja metodą Otsu (automatyczne znajdowanie progu)
     static void otsuBinarization(std::unique_ptr<Image>& image);
 
+    // Binaryzacja adaptacyjna Sauvoli: próg lokalny T = m * (1 + k * (s / 128 - 1)), gdzie m i s to
+    // średnia i odchylenie standardowe luminancji w oknie windowSize x windowSize (obcinanym na
+    // brzegach obrazu). Sumy okien z tablic sum prefiksowych - koszt niezależny od rozmiaru okna.
+    static void sauvolaBinarization(std::unique_ptr<Image>& image, int windowSize = 31, double k = 0.34);
+
 private:
-    // Funkcja pomocnicza do konwersji na skalę szarości (jeśli potrzebna)
-    static int rgbToGray(int r, int g, int b);
-    
     // Funkcje pomocnicze dla metody Otsu
     static std::vector<int> calculateHistogram(std::unique_ptr<Image>& image);
     static int findOtsuThreshold(const std::vector<int>& histogram);
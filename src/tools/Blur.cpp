@@ -1,12 +1,259 @@
 #include "Blur.h"
+#include "../core/Convolution.h"
+#include "../core/HaloRows.h"
+#include "../core/Parallel.h"
 #include <algorithm>
+#include <array>
 #include <cmath>
 
-void Blur::gaussianBlur(std::unique_ptr<Image>& image, double sigma, int kernelSize) {
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define BLUR_SSE2 1
+#endif
+
+namespace {
+
+inline int toChannel(float value) {
+    return std::clamp(static_cast<int>(value + 0.5f), 0, 255);
+}
+
+// Współczynniki filtru rekurencyjnego Younga-van Vlieta:
+// w[n] = B * x[n] + a1 * w[n - 1] + a2 * w[n - 2] + a3 * w[n - 3] (i to samo wstecz).
+// Dla dużych sigma B jest rzędu 1e-5 i błędy zaokrągleń float wzmacniane są ~1/B razy,
+// dlatego rekurencja liczona jest w double.
+struct RecursiveCoefficients {
+    double B, a1, a2, a3;
+    // Stany początkowe przebiegu wstecznego z trzech ostatnich wyników przebiegu w przód
+    // (warunki brzegowe Triggsa-Sdiki dla powielonego brzegu)
+    double M[3][3];
+};
+
+RecursiveCoefficients makeRecursiveCoefficients(double sigma) {
+    double q = sigma >= 2.5 ? 0.98711 * sigma - 0.96330
+                            : 3.97156 - 4.14554 * std::sqrt(1.0 - 0.26891 * sigma);
+    double b0 = 1.57825 + 2.44413 * q + 1.4281 * q * q + 0.422205 * q * q * q;
+    RecursiveCoefficients c{};
+    c.a1 = (2.44413 * q + 2.85619 * q * q + 1.26661 * q * q * q) / b0;
+    c.a2 = -(1.4281 * q * q + 1.26661 * q * q * q) / b0;
+    c.a3 = 0.422205 * q * q * q / b0;
+    c.B = 1.0 - (c.a1 + c.a2 + c.a3);
+    
+    // Macierz M wyznaczana numerycznie: za prawym brzegiem sygnał jest stały, więc odchylenie
+    // od niego zanika - przebieg w przód z jednostkowym stanem, potem wstecz od daleka
+    int length = 64 + static_cast<int>(30 * sigma);
+    std::vector<double> forward(length + 3), backward(length + 6);
+    for (int j = 0; j < 3; ++j) {
+        // forward[0..2] = w[N - 3], w[N - 2], w[N - 1]
+        std::fill(forward.begin(), forward.end(), 0.0);
+        forward[2 - j] = 1.0;
+        for (int n = 3; n < length + 3; ++n) {
+            forward[n] = c.a1 * forward[n - 1] + c.a2 * forward[n - 2] + c.a3 * forward[n - 3];
+        }
+        std::fill(backward.begin(), backward.end(), 0.0);
+        for (int n = length + 2; n >= 3; --n) {
+            backward[n] = c.B * forward[n] + c.a1 * backward[n + 1] + c.a2 * backward[n + 2] + c.a3 * backward[n + 3];
+        }
+        // backward[3..5] = y[N], y[N + 1], y[N + 2]
+        for (int i = 0; i < 3; ++i) {
+            c.M[i][j] = backward[3 + i];
+        }
+    }
+    return c;
+}
+
+// dst[x] = B * src[x] + a1 * p1[x] + a2 * p2[x] + a3 * p3[x] (dst może być równe src)
+void recursiveStep(double* dst, const double* src, const double* p1, const double* p2, const double* p3,
+                   const RecursiveCoefficients& c, int count) {
+    int x = 0;
+#ifdef BLUR_SSE2
+    __m128d B = _mm_set1_pd(c.B), a1 = _mm_set1_pd(c.a1), a2 = _mm_set1_pd(c.a2), a3 = _mm_set1_pd(c.a3);
+    for (; x + 2 <= count; x += 2) {
+        __m128d v = _mm_mul_pd(B, _mm_loadu_pd(src + x));
+        v = _mm_add_pd(v, _mm_mul_pd(a1, _mm_loadu_pd(p1 + x)));
+        v = _mm_add_pd(v, _mm_mul_pd(a2, _mm_loadu_pd(p2 + x)));
+        v = _mm_add_pd(v, _mm_mul_pd(a3, _mm_loadu_pd(p3 + x)));
+        _mm_storeu_pd(dst + x, v);
+    }
+#endif
+    for (; x < count; ++x) {
+        dst[x] = c.B * src[x] + c.a1 * p1[x] + c.a2 * p2[x] + c.a3 * p3[x];
+    }
+}
+
+// Filtr rekurencyjny wzdłuż kolumn płaszczyzny (rows wierszy po stride próbek) dla kolumn
+// [x0, x1) - każdy krok przetwarza cały odcinek wiersza, więc działa wektorowo na wielu kolumnach
+void recursiveColumns(double* plane, int stride, int rows, int x0, int x1, const RecursiveCoefficients& c) {
+    int count = x1 - x0;
+    auto row = [&](int n) { return plane + static_cast<size_t>(n) * stride + x0; };
+    
+    // Brzegi powielane: przed początkiem stały sygnał x[0], za końcem stały x[N - 1]
+    std::vector<double> first(row(0), row(0) + count);
+    std::vector<double> last(row(rows - 1), row(rows - 1) + count);
+    
+    // Przebieg w przód (w miejscu)
+    const double* p1 = first.data();
+    const double* p2 = first.data();
+    const double* p3 = first.data();
+    for (int n = 0; n < rows; ++n) {
+        recursiveStep(row(n), row(n), p1, p2, p3, c, count);
+        p3 = p2;
+        p2 = p1;
+        p1 = row(n);
+    }
+    
+    // Stany początkowe przebiegu wstecznego: y[N + i] = u + suma M[i][j] * (w[N - 1 - j] - u)
+    std::vector<double> tail(3 * static_cast<size_t>(count));
+    const double* w[3] = {row(rows - 1), row(rows - 2), row(rows - 3)};
+    for (int x = 0; x < count; ++x) {
+        double u = last[x];
+        for (int i = 0; i < 3; ++i) {
+            double value = u;
+            for (int j = 0; j < 3; ++j) {
+                value += c.M[i][j] * (w[j][x] - u);
+            }
+            tail[i * count + x] = value;
+        }
+    }
+    
+    // Przebieg wstecz (w miejscu)
+    p1 = tail.data();
+    p2 = tail.data() + count;
+    p3 = tail.data() + 2 * count;
+    for (int n = rows - 1; n >= 0; --n) {
+        recursiveStep(row(n), row(n), p1, p2, p3, c, count);
+        p3 = p2;
+        p2 = p1;
+        p1 = row(n);
+    }
+}
+
+// Transpozycja płaszczyzny height x width do width x height, blokami mieszczącymi się w cache
+void transposePlane(const double* src, double* dst, int width, int height) {
+    constexpr int Block = 32;
+    int blocksY = (height + Block - 1) / Block;
+    Parallel::forRange(blocksY, [&](int begin, int end) {
+        for (int by = begin; by < end; ++by) {
+            int y0 = by * Block, y1 = std::min(y0 + Block, height);
+            for (int x0 = 0; x0 < width; x0 += Block) {
+                int x1 = std::min(x0 + Block, width);
+                for (int y = y0; y < y1; ++y) {
+                    for (int x = x0; x < x1; ++x) {
+                        dst[static_cast<size_t>(x) * height + y] = src[static_cast<size_t>(y) * width + x];
+                    }
+                }
+            }
+        }
+    }, 1);
+}
+
+// Pasy wątków dla runningBoxSums
+int boxBandCount(int height, int radius) {
+    return Parallel::bandCount(height, std::max(64, 4 * radius + 2));
+}
+
+// Sumy w oknach (2 * radius + 1)² z powielonym brzegiem dla Channels płaszczyzn: okno przesuwane
+// poziomo (jeden piksel wchodzi, jeden wychodzi), potem sumy kolumn przesuwane w dół.
+// sample(y) zwraca funkcję (c, x) dającą próbkę kanału c w wierszu y (x i y w obrazie),
+// store(y, columns) dostaje sumy okien wiersza y: columns[c * width + x]. Sum to typ akumulatora
+// i sum poziomych.
+// Sumy poziome nie tworzą płaszczyzny: każdy pas trzyma tylko wiersze aktualnego okna
+// (min(2 * radius + 2, height) wierszy), liczone gdy wchodzą do okna.
+template <typename Sum, int Channels, typename Sample, typename Store>
+void runningBoxSums(int width, int height, int radius, Sample sample, Store store) {
+    int slots = std::min(2 * radius + 2, height);
+    
+    // Każdy pas startuje od własnego okna, więc koszt inicjalizacji rośnie z promieniem
+    Parallel::forBands(height, boxBandCount(height, radius), [&](int, int begin, int end) {
+        // Wiersz źródła y zajmuje miejsce y % slots - wiersze okna to ciągły zakres, więc się nie nakładają
+        std::vector<Sum> rows(static_cast<size_t>(slots) * Channels * width);
+        std::vector<int> slotRow(slots, -1);
+        auto horizontalSums = [&](int y) {
+            y = std::clamp(y, 0, height - 1);
+            Sum* sum = rows.data() + static_cast<size_t>(y % slots) * Channels * width;
+            if (slotRow[y % slots] == y) {
+                return static_cast<const Sum*>(sum);
+            }
+            slotRow[y % slots] = y;
+            // Wszystkie kanały w jednym przejściu po wierszu - każdy piksel czytany raz
+            auto at = sample(y);
+            Sum s[Channels] = {};
+            for (int dx = -radius; dx <= radius; ++dx) {
+                for (int c = 0; c < Channels; ++c) {
+                    s[c] += at(c, std::clamp(dx, 0, width - 1));
+                }
+            }
+            for (int x = 0; x < width; ++x) {
+                int incoming = std::min(x + radius + 1, width - 1);
+                int outgoing = std::max(x - radius, 0);
+                for (int c = 0; c < Channels; ++c) {
+                    sum[static_cast<size_t>(c) * width + x] = s[c];
+                    s[c] += at(c, incoming) - at(c, outgoing);
+                }
+            }
+            return static_cast<const Sum*>(sum);
+        };
+        
+        std::vector<Sum> columns(static_cast<size_t>(Channels) * width, Sum{});
+        for (int dy = -radius; dy <= radius; ++dy) {
+            const Sum* sum = horizontalSums(begin + dy);
+            for (size_t i = 0; i < columns.size(); ++i) {
+                columns[i] += sum[i];
+            }
+        }
+        
+        for (int y = begin; y < end; ++y) {
+            store(y, static_cast<const Sum*>(columns.data()));
+            if (y + 1 < end) {
+                // Okno w dół: wiersz y + radius + 1 wchodzi, wiersz y - radius wychodzi
+                const Sum* outgoing = horizontalSums(y - radius);
+                const Sum* incoming = horizontalSums(y + radius + 1);
+                for (size_t i = 0; i < columns.size(); ++i) {
+                    columns[i] += incoming[i] - outgoing[i];
+                }
+            }
+        }
+    });
+}
+
+// Średnie w oknie (2 * radius + 1)² dla Channels płaszczyzn naraz (sample jak w runningBoxSums) -
+// te same sumy bieżące co applyBoxFilter, akumulowane i zapamiętywane w double
+template <int Channels, typename Sample>
+std::array<Plane, Channels> boxMeans(int width, int height, int radius, Sample sample) {
+    int kernelSize = 2 * radius + 1;
+    double scale = 1.0 / (static_cast<double>(kernelSize) * kernelSize);
+    std::array<Plane, Channels> means;
+    for (Plane& mean : means) {
+        mean = Plane(width, height);
+    }
+    runningBoxSums<double, Channels>(width, height, radius, sample, [&](int y, const double* columns) {
+        for (int c = 0; c < Channels; ++c) {
+            float* out = means[c].row(y);
+            const double* sums = columns + static_cast<size_t>(c) * width;
+            for (int x = 0; x < width; ++x) {
+                out[x] = static_cast<float>(sums[x] * scale);
+            }
+        }
+    });
+    return means;
+}
+
+} // namespace
+
+void Blur::gaussianBlur(std::unique_ptr<Image>& image, double sigma, int kernelSize, GaussianMode mode) {
     if (!image || sigma <= 0) {
         return;
     }
     
+    // Jawnie podany rozmiar jądra oznacza obcięty filtr FIR
+    if (mode == GaussianMode::Automatic) {
+        mode = kernelSize <= 0 && sigma >= RecursiveSigmaThreshold ? GaussianMode::Recursive : GaussianMode::FIR;
+    }
+    // Filtr rekurencyjny wymaga co najmniej trzech próbek w każdym kierunku
+    if (mode == GaussianMode::Recursive && sigma >= 0.5 && image->width() >= 3 && image->height() >= 3) {
+        applyRecursiveGaussian(image, sigma);
+        return;
+    }
+    
     // Obliczanie rozmiaru jądra jeśli nie został podany
     if (kernelSize <= 0) {
         kernelSize = calculateKernelSize(sigma);
@@ -17,10 +264,9 @@ void Blur::gaussianBlur(std::unique_ptr<Image>& image, double sigma, int kernelS
         kernelSize++;
     }
     
-    // Generowanie jądra Gaussa
-    auto kernel = generateGaussianKernel(sigma, kernelSize);
-      // Aplikowanie konwolucji
-    applyConvolution(image, kernel);
+    // Jądro Gaussa jest separowalne: dwa przebiegi 1D zamiast splotu 2D (2k zamiast k² mnożeń)
+    auto kernel = generateGaussianKernel1D(sigma, kernelSize);
+    Convolution::applySeparable(image->bits(), image->width(), image->height(), {{kernel, kernel}});
 }
 
 void Blur::uniformBlur(std::unique_ptr<Image>& image, int kernelSize) {
@@ -34,74 +280,48 @@ void Blur::uniformBlur(std::unique_ptr<Image>& image, int kernelSize) {
     }
     
     // Minimum 3x3
-    if (kernelSize < 3) {
-        kernelSize = 3;
-    }
-    
-    // Generowanie jądra równomiernego
-    auto kernel = generateUniformKernel(kernelSize);
+    kernelSize = std::clamp(kernelSize, 3, MaxUniformKernelSize);
     
-    // Aplikowanie konwolucji
-    applyConvolution(image, kernel);
+    applyBoxFilter(image, kernelSize);
 }
 
-void Blur::customMatrixBlur(std::unique_ptr<Image>& image, const std::vector<std::vector<double>>& matrix) {
+std::string Blur::customMatrixBlur(std::unique_ptr<Image>& image, const std::vector<std::vector<double>>& matrix) {
     if (!image || matrix.empty() || matrix[0].empty()) {
-        return;
+        return {};
     }
     
     // Sprawdzenie czy macierz jest kwadratowa
     size_t size = matrix.size();
     for (const auto& row : matrix) {
         if (row.size() != size) {
-            return; // Macierz nie jest kwadratowa
+            return {}; // Macierz nie jest kwadratowa
         }
     }
     
     // Sprawdzenie czy rozmiar jest nieparzysty (wymagane dla konwolucji)
     if (size % 2 == 0) {
-        return; // Rozmiar musi być nieparzysty
+        return {}; // Rozmiar musi być nieparzysty
     }
     
-    // Aplikowanie konwolucji z niestandardową macierzą
-    applyConvolution(image, matrix);
+    // Jądra separowalne (Gauss, box) i niskiego rzędu - przebiegi 1D, duże jądra pełnego rzędu - FFT
+    return Convolution::apply(image->bits(), image->width(), image->height(), matrix);
 }
 
-std::vector<std::vector<double>> Blur::generateGaussianKernel(double sigma, int size) {
-    std::vector<std::vector<double>> kernel(size, std::vector<double>(size));
+std::vector<double> Blur::generateGaussianKernel1D(double sigma, int size) {
+    std::vector<double> kernel(size);
     double sum = 0.0;
     int center = size / 2;
     
-    // Obliczanie wartości jądra według wzoru Gaussa
+    // Obliczanie wartości jądra według wzoru Gaussa: e^(-x²/(2*σ²))
     for (int x = 0; x < size; x++) {
-        for (int y = 0; y < size; y++) {
-            double value = gaussianFunction(x - center, y - center, sigma);
-            kernel[x][y] = value;
-            sum += value;
-        }
+        kernel[x] = std::exp(-((x - center) * (x - center)) / (2.0 * sigma * sigma));
+        sum += kernel[x];
     }
     
     // Normalizacja jądra (suma wszystkich elementów = 1)
     for (int x = 0; x < size; x++) {
-        for (int y = 0; y < size; y++) {
-            kernel[x][y] /= sum;
-        }
-    }
-      return kernel;
-}
-
-std::vector<std::vector<double>> Blur::generateUniformKernel(int size) {
-    std::vector<std::vector<double>> kernel(size, std::vector<double>(size));
-    
-    // Wszystkie elementy jądra mają taką samą wartość
-    double value = 1.0 / (size * size);
-    
-    for (int x = 0; x < size; x++) {
-        for (int y = 0; y < size; y++) {
-            kernel[x][y] = value;
-        }
+        kernel[x] /= sum;
     }
-    
     return kernel;
 }
 
@@ -115,55 +335,183 @@ int Blur::calculateKernelSize(double sigma) {
     return std::max(3, size);
 }
 
-double Blur::gaussianFunction(int x, int y, double sigma) {
-    // Wzór funkcji Gaussa: (1/(2*π*σ²)) * e^(-(x²+y²)/(2*σ²))
-    double exponent = -(x * x + y * y) / (2.0 * sigma * sigma);
-    return (1.0 / (2.0 * M_PI * sigma * sigma)) * std::exp(exponent);
+void Blur::applyRecursiveGaussian(std::unique_ptr<Image>& image, double sigma) {
+    int width = image->width();
+    int height = image->height();
+    size_t planeSize = static_cast<size_t>(width) * height;
+    RecursiveCoefficients coefficients = makeRecursiveCoefficients(sigma);
+    
+    // Filtr wzdłuż kolumn działa na całych wierszach; wątki dzielą się pasami kolumn.
+    // Kierunek poziomy to ten sam filtr na transponowanej płaszczyźnie.
+    constexpr int StripWidth = 256;
+    auto filterColumns = [&](double* plane, int columns, int rows) {
+        int strips = (columns + StripWidth - 1) / StripWidth;
+        Parallel::forRange(strips, [&](int begin, int end) {
+            for (int strip = begin; strip < end; ++strip) {
+                int x0 = strip * StripWidth;
+                recursiveColumns(plane, columns, rows, x0, std::min(x0 + StripWidth, columns), coefficients);
+            }
+        }, 1);
+    };
+    
+    // Kanały po kolei, każdy w płaszczyźnie double i jej transpozycji
+    std::vector<double> plane(planeSize);
+    std::vector<double> transposed(planeSize);
+    QRgb* pixels = image->bits();
+    for (int c = 0; c < 3; ++c) {
+        int shift = 16 - 8 * c;
+        Parallel::forRange(height, [&](int begin, int end) {
+            for (int y = begin; y < end; ++y) {
+                const QRgb* row = pixels + static_cast<size_t>(y) * width;
+                double* line = plane.data() + static_cast<size_t>(y) * width;
+                for (int x = 0; x < width; ++x) {
+                    line[x] = static_cast<double>((row[x] >> shift) & 0xFF);
+                }
+            }
+        }, 16);
+        
+        filterColumns(plane.data(), width, height);
+        transposePlane(plane.data(), transposed.data(), width, height);
+        filterColumns(transposed.data(), height, width);
+        transposePlane(transposed.data(), plane.data(), height, width);
+        
+        Parallel::forRange(height, [&](int begin, int end) {
+            for (int y = begin; y < end; ++y) {
+                QRgb* row = pixels + static_cast<size_t>(y) * width;
+                const double* line = plane.data() + static_cast<size_t>(y) * width;
+                for (int x = 0; x < width; ++x) {
+                    uint32_t value = static_cast<uint32_t>(toChannel(static_cast<float>(line[x])));
+                    row[x] = (row[x] & ~(0xFFu << shift)) | (value << shift);
+                }
+            }
+        }, 16);
+    }
 }
 
-void Blur::applyConvolution(std::unique_ptr<Image>& image, const std::vector<std::vector<double>>& kernel) {
+void Blur::applyBoxFilter(std::unique_ptr<Image>& image, int kernelSize) {
     int width = image->width();
     int height = image->height();
-    int kernelSize = kernel.size();
-    int kernelRadius = kernelSize / 2;
-    
-    // Tworzymy kopię oryginalnego obrazu do odczytu wartości
-    std::vector<std::vector<QColor>> originalPixels(width, std::vector<QColor>(height));
-    for (int x = 0; x < width; x++) {
-        for (int y = 0; y < height; y++) {
-            originalPixels[x][y] = image->pixelAt(x, y);
+    int radius = kernelSize / 2;
+    double scale = 1.0 / (static_cast<double>(kernelSize) * kernelSize);
+    
+    // Sumy całkowite (R, G, B) - dokładne, zaokrąglenie tylko przy zapisie. Wynik zapisywany
+    // w miejscu - kopiowane są tylko wiersze przy granicach pasów.
+    QRgb* pixels = image->bits();
+    HaloRows source(pixels, width, height, boxBandCount(height, radius), radius, Convolution::Border::Replicate);
+    runningBoxSums<uint32_t, 3>(width, height, radius,
+        [&](int y) {
+            const QRgb* row = source.row(y);
+            return [row](int c, int x) { return (row[x] >> (16 - 8 * c)) & 0xFFu; };
+        },
+        [&](int y, const uint32_t* columns) {
+            QRgb* row = pixels + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; ++x) {
+                row[x] = qRgb(static_cast<int>(columns[x] * scale + 0.5),
+                              static_cast<int>(columns[width + x] * scale + 0.5),
+                              static_cast<int>(columns[2 * width + x] * scale + 0.5));
+            }
+        });
+}
+
+Plane Blur::guidedFilter(const Plane& input, const Plane& guide, int radius, double epsilon) {
+    int width = input.width();
+    int height = input.height();
+    float eps = static_cast<float>(epsilon);
+    
+    // Średnie I, p, I * I i I * p w jednym przebiegu; iloczyny liczone w double przy sumowaniu
+    auto [meanI, meanP, corrI, corrIp] = boxMeans<4>(width, height, radius, [&](int y) {
+        const float* guideRow = guide.row(y);
+        const float* inputRow = input.row(y);
+        return [guideRow, inputRow](int c, int x) {
+            double I = guideRow[x];
+            double p = inputRow[x];
+            switch (c) {
+                case 0: return I;
+                case 1: return p;
+                case 2: return I * I;
+                default: return I * p;
+            }
+        };
+    });
+    
+    // Współczynniki modelu liniowego w każdym oknie (a w miejscu corrI, b w miejscu corrIp)
+    Plane& a = corrI;
+    Plane& b = corrIp;
+    Parallel::forRange(height, [&](int begin, int end) {
+        for (int y = begin; y < end; ++y) {
+            const float* mI = meanI.row(y);
+            const float* mP = meanP.row(y);
+            float* rowA = a.row(y);
+            float* rowB = b.row(y);
+            for (int x = 0; x < width; ++x) {
+                float variance = std::max(rowA[x] - mI[x] * mI[x], 0.0f);
+                float covariance = rowB[x] - mI[x] * mP[x];
+                rowA[x] = covariance / (variance + eps);
+                rowB[x] = mP[x] - rowA[x] * mI[x];
+            }
         }
-    }
+    });
     
-    // Aplikowanie konwolucji
-    for (int x = 0; x < width; x++) {
-        for (int y = 0; y < height; y++) {
-            double newR = 0.0, newG = 0.0, newB = 0.0;
-            
-            // Iteracja przez jądro
-            for (int kx = 0; kx < kernelSize; kx++) {
-                for (int ky = 0; ky < kernelSize; ky++) {
-                    int pixelX = x + kx - kernelRadius;
-                    int pixelY = y + ky - kernelRadius;
-                    
-                    // Obsługa pikseli poza granicami obrazu (odbicie)
-                    pixelX = std::max(0, std::min(width - 1, pixelX));
-                    pixelY = std::max(0, std::min(height - 1, pixelY));
-                    
-                    QColor pixel = originalPixels[pixelX][pixelY];
-                    double kernelValue = kernel[kx][ky];
-                    
-                    newR += pixel.red() * kernelValue;
-                    newG += pixel.green() * kernelValue;
-                    newB += pixel.blue() * kernelValue;
-                }
+    // Wynik: uśrednione współczynniki wszystkich okien zawierających piksel
+    auto [meanA, meanB] = boxMeans<2>(width, height, radius, [&](int y) {
+        const float* rows[2] = {a.row(y), b.row(y)};
+        return [rows](int c, int x) { return static_cast<double>(rows[c][x]); };
+    });
+    Plane result(width, height);
+    Parallel::forRange(height, [&](int begin, int end) {
+        for (int y = begin; y < end; ++y) {
+            const float* I = guide.row(y);
+            const float* mA = meanA.row(y);
+            const float* mB = meanB.row(y);
+            float* q = result.row(y);
+            for (int x = 0; x < width; ++x) {
+                q[x] = mA[x] * I[x] + mB[x];
             }
-            
-            // Ograniczenie wartości do zakresu 0-255 i ustawienie nowego piksela
-            image->setPixel(x, y, clamp(static_cast<int>(newR)),
-                                 clamp(static_cast<int>(newG)),
-                                 clamp(static_cast<int>(newB)));
         }
+    });
+    return result;
+}
+
+void Blur::guidedFilter(std::unique_ptr<Image>& image, int radius, double epsilon, GuideMode mode) {
+    if (!image || radius <= 0 || epsilon <= 0) {
+        return;
+    }
+    int width = image->width();
+    int height = image->height();
+    size_t count = image->pixelCount();
+    QRgb* pixels = image->bits();
+    
+    // Kanały jako płaszczyzny 0-1
+    Plane channels[3] = {Plane(width, height), Plane(width, height), Plane(width, height)};
+    Parallel::forRange(height, [&](int begin, int end) {
+        for (size_t i = static_cast<size_t>(begin) * width; i < static_cast<size_t>(end) * width; ++i) {
+            channels[0].data()[i] = qRed(pixels[i]) * (1.0f / 255.0f);
+            channels[1].data()[i] = qGreen(pixels[i]) * (1.0f / 255.0f);
+            channels[2].data()[i] = qBlue(pixels[i]) * (1.0f / 255.0f);
+        }
+    });
+    
+    Plane luminance;
+    if (mode == GuideMode::Luminance) {
+        luminance = Plane::fromLuma(pixels, width, height);
+        float* values = luminance.data();
+        for (size_t i = 0; i < count; ++i) {
+            values[i] *= 1.0f / 255.0f;
+        }
+    }
+    
+    for (int c = 0; c < 3; ++c) {
+        const Plane& guide = mode == GuideMode::Luminance ? luminance : channels[c];
+        Plane filtered = guidedFilter(channels[c], guide, radius, epsilon);
+        
+        int shift = 16 - 8 * c;
+        const float* values = filtered.data();
+        Parallel::forRange(height, [&](int begin, int end) {
+            for (size_t i = static_cast<size_t>(begin) * width; i < static_cast<size_t>(end) * width; ++i) {
+                uint32_t value = static_cast<uint32_t>(toChannel(values[i] * 255.0f));
+                pixels[i] = (pixels[i] & ~(0xFFu << shift)) | (value << shift);
+            }
+        });
     }
 }
 
@@ -2,36 +2,70 @@
 #define BLUR_H
 
 #include <memory>
+#include <string>
 #include <vector>
 #include <cmath>
 #include "../image/Image.h"
+#include "../core/Plane.h"
 
 class Blur {
 public:
+    // Sposób liczenia rozmycia Gaussa:
+    //  FIR       - jądro o rozmiarze kernelSize, dwa przebiegi 1D (koszt rośnie liniowo z sigma)
+    //  Recursive - filtr rekurencyjny Younga-van Vlieta (stały koszt na piksel, przybliżenie Gaussa)
+    //  Automatic - Recursive dla sigma >= RecursiveSigmaThreshold bez jawnego kernelSize, inaczej FIR
+    //
+    // Dokładność Recursive względem FIR, maks. / średnia różnica w skali 0-255
+    // (szum losowy; sinusoida z szachownicą; skok jasności):
+    //   sigma  5: 2 / 0.21;  5 / 0.84;  3 / 0.19
+    //   sigma 15: 1 / 0.06;  3 / 0.59;  2 / 0.38
+    //   sigma 30: 1 / 0.04;  1 / 0.13;  2 / 0.58
+    //   sigma 80: 1 / 0.10;  1 / 0.17;  2 / 1.12
+    // Dla sigma < 3 kształt odpowiedzi wyraźnie odbiega od Gaussa (do 16 przy sigma 1).
+    // Próg to punkt, w którym filtr rekurencyjny staje się szybszy od FIR (ok. 1.8 s na 20 MP).
+    enum class GaussianMode { Automatic, FIR, Recursive };
+    static constexpr double RecursiveSigmaThreshold = 15.0;
+    
     // Funkcja główna dla rozmycia Gaussa
-    static void gaussianBlur(std::unique_ptr<Image>& image, double sigma, int kernelSize = 0);
+    static void gaussianBlur(std::unique_ptr<Image>& image, double sigma, int kernelSize = 0,
+                             GaussianMode mode = GaussianMode::Automatic);
     
-    // Funkcja dla rozmycia równomiernego (box blur)
+    // Funkcja dla rozmycia równomiernego (box blur) - sumy bieżące, koszt niezależny od rozmiaru jądra
     static void uniformBlur(std::unique_ptr<Image>& image, int kernelSize);
     
-    // Funkcja dla niestandardowego rozmycia z zadaną macierzą
-    static void customMatrixBlur(std::unique_ptr<Image>& image, const std::vector<std::vector<double>>& matrix);
-
-private:
-    // Generowanie jądra Gaussa
-    static std::vector<std::vector<double>> generateGaussianKernel(double sigma, int size);
+    // Największe jądro, dla którego suma okna (255 * k²) mieści się w uint32
+    static constexpr int MaxUniformKernelSize = 4095;
+    
+    // Filtr prowadzony (He i in.): wygładzanie z zachowaniem krawędzi obrazu prowadzącego.
+    // q = mean(a) * I + mean(b), gdzie a = cov(I, p) / (var(I) + epsilon), b = mean(p) - a * mean(I)
+    // w oknach (2 * radius + 1)²; wartości w skali 0-1, więc epsilon = 0.1² wygładza zmiany
+    // jasności mniejsze niż ok. 10% zakresu. Kilka filtrów pudełkowych na płaszczyznach float -
+    // koszt niezależny od promienia.
+    //  Self      - każdy kanał prowadzony sam sobą,
+    //  Luminance - wszystkie kanały prowadzone luminancją (wspólne krawędzie, bez przesunięć koloru)
+    enum class GuideMode { Self, Luminance };
+    static void guidedFilter(std::unique_ptr<Image>& image, int radius, double epsilon,
+                             GuideMode mode = GuideMode::Self);
     
-    // Generowanie jądra równomiernego
-    static std::vector<std::vector<double>> generateUniformKernel(int size);
+    // Filtr prowadzony dla płaszczyzn (input i guide tego samego rozmiaru, wartości 0-1)
+    static Plane guidedFilter(const Plane& input, const Plane& guide, int radius, double epsilon);
     
+    // Funkcja dla niestandardowego rozmycia z zadaną macierzą. Ścieżkę (splot 2D, przebiegi 1D
+    // lub FFT) wybiera Convolution::plan; zwraca opis wybranej ścieżki (pusty przy błędzie).
+    static std::string customMatrixBlur(std::unique_ptr<Image>& image, const std::vector<std::vector<double>>& matrix);
+
+    // Generowanie jednowymiarowego jądra Gaussa (znormalizowanego)
+    static std::vector<double> generateGaussianKernel1D(double sigma, int size);
+
+private:
     // Obliczanie optymalnego rozmiaru jądra na podstawie sigma
     static int calculateKernelSize(double sigma);
     
-    // Funkcja Gaussa
-    static double gaussianFunction(int x, int y, double sigma);
+    // Rekurencyjny filtr Gaussa (Young-van Vliet) z warunkami brzegowymi Triggsa-Sdiki
+    static void applyRecursiveGaussian(std::unique_ptr<Image>& image, double sigma);
     
-    // Aplikowanie jądra konwolucji do obrazu
-    static void applyConvolution(std::unique_ptr<Image>& image, const std::vector<std::vector<double>>& kernel);
+    // Rozmycie pudełkowe k x k: przesuwane sumy poziomo, a potem pionowo
+    static void applyBoxFilter(std::unique_ptr<Image>& image, int kernelSize);
     
     // Funkcja pomocnicza do ograniczenia wartości do zakresu 0-255
     static int clamp(int value, int min = 0, int max = 255);
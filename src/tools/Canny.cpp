@@ -1,6 +1,7 @@
 #include "Canny.h"
 #include "Blur.h"
-#include "Greyscale.h"
+#include "../core/Parallel.h"
+#include "../core/StaticConvolution.h"
 #include <cmath>
 #include <algorithm>
 #include <stack>
@@ -9,35 +10,29 @@ void Canny::applyCanny(std::unique_ptr<Image>& image, double upperThresh, double
     if (!image) return;
     
     try {
-        step1_convertToGrayscale(image);
+        Plane plane = step1_convertToGrayscale(image);
         
-        step2_applyGaussianBlur(image);
+        step2_applyGaussianBlur(plane);
         
-        std::vector<std::vector<double>> gradientX, gradientY;
-        step3_computeSobelGradients(image, gradientX, gradientY);
+        Plane gradientX, gradientY;
+        step3_computeSobelGradients(plane, gradientX, gradientY);
         
-        std::vector<std::vector<double>> magnitude, direction;
+        Plane magnitude, direction;
         step4_computeMagnitudeAndDirection(gradientX, gradientY, magnitude, direction);
         
         upperThresh = std::max(1.0, upperThresh);
         lowerThresh = std::max(1.0, std::min(lowerThresh, upperThresh * 0.8));
-        std::vector<std::vector<bool>> strongEdges;
+        std::vector<uint8_t> strongEdges;
         step5_nonMaximumSuppression(magnitude, direction, strongEdges, upperThresh);
         
-        std::vector<std::vector<bool>> finalEdges;
+        std::vector<uint8_t> finalEdges;
         step6_hysteresisThresholding(magnitude, direction, strongEdges, finalEdges, lowerThresh);
 
-        // Zastąpienie obrazu wynikiem
-        int width = image->width();
-        int height = image->height();
-        for (int x = 0; x < width; x++) {
-            for (int y = 0; y < height; y++) {
-                if (finalEdges[x][y]) {
-                    image->setPixel(x, y, 255, 255, 255); // biała krawędź
-                } else {
-                    image->setPixel(x, y, 0, 0, 0); // czarne tło
-                }
-            }
+        // Zastąpienie obrazu wynikiem - jedyny zapis do pikseli w całym łańcuchu
+        uint32_t* pixels = image->bits();
+        for (size_t i = 0; i < finalEdges.size(); i++) {
+            // biała krawędź, czarne tło
+            pixels[i] = finalEdges[i] ? qRgb(255, 255, 255) : qRgb(0, 0, 0);
         }
         
     } catch (const std::exception& e) {
@@ -46,101 +41,74 @@ void Canny::applyCanny(std::unique_ptr<Image>& image, double upperThresh, double
     }
 }
 
-void Canny::step1_convertToGrayscale(std::unique_ptr<Image>& image) {
-    Greyscale::convertToGreyscale(image);
-}
-
-void Canny::step2_applyGaussianBlur(std::unique_ptr<Image>& image) {
-    Blur::gaussianBlur(image, 1.6, 3);
+Plane Canny::step1_convertToGrayscale(const std::unique_ptr<Image>& image) {
+    // Wagi jak w Greyscale::convertToGreyscale, ale bez zaokrąglania do 8 bitów
+    return Plane::fromLuma(image->constBits(), image->width(), image->height());
 }
 
-void Canny::step3_computeSobelGradients(std::unique_ptr<Image>& image,
-                                       std::vector<std::vector<double>>& gradientX,
-                                       std::vector<std::vector<double>>& gradientY) {
-    int width = image->width();
-    int height = image->height();
-    
-    // Inicjalizacja tablic gradientów
-    gradientX.assign(width, std::vector<double>(height, 0.0));
-    gradientY.assign(width, std::vector<double>(height, 0.0));
-    
-    // Generowanie Kerneli Sobela
-    auto sobelKernels = generateSobelKernels();
-    auto sobelX = sobelKernels.first;  // rawHorizontalDetection
-    auto sobelY = sobelKernels.second; // rawVerticalDetection
-    
-    std::vector<std::vector<int>> originalPixels(width, std::vector<int>(height));
-    for (int x = 0; x < width; x++) {
-        for (int y = 0; y < height; y++) {
-            // Ponieważ obraz jest już w skali szarości, używamy tylko jednego kanału
-            originalPixels[x][y] = image->getPixelR(x, y);
-        }
-    }
-    
-    // Obliczenie gradientów Gx i Gy
-    for (int x = 0; x < width; x++) {
-        for (int y = 0; y < height; y++) {
-            double gx = 0.0, gy = 0.0;
-            
-            // Aplikowanie operatora Sobela
-            for (int kx = 0; kx < 3; kx++) {
-                for (int ky = 0; ky < 3; ky++) {
-                    int pixelX = std::max(0, std::min(width - 1, x + kx - 1));
-                    int pixelY = std::max(0, std::min(height - 1, y + ky - 1));
-                    
-                    int intensity = originalPixels[pixelX][pixelY];
-                    
-                    gx += intensity * sobelX[kx][ky];
-                    gy += intensity * sobelY[kx][ky];
-                }
-            }
-            
-            gradientX[x][y] = gx;
-            gradientY[x][y] = gy;
+void Canny::step2_applyGaussianBlur(Plane& plane) {
+    // Jak Blur::gaussianBlur(image, 1.6, 3), na płaszczyźnie float
+    std::vector<double> kernel1D = Blur::generateGaussianKernel1D(1.6, 3);
+    std::vector<std::vector<double>> kernel(kernel1D.size(), std::vector<double>(kernel1D.size()));
+    for (size_t x = 0; x < kernel1D.size(); x++) {
+        for (size_t y = 0; y < kernel1D.size(); y++) {
+            kernel[x][y] = kernel1D[x] * kernel1D[y];
         }
     }
+    plane = plane.convolved(kernel);
+}
+
+void Canny::step3_computeSobelGradients(const Plane& plane, Plane& gradientX, Plane& gradientY) {
+    // Obliczenie gradientów Gx i Gy (rawHorizontalDetection, rawVerticalDetection) na rozmytej płaszczyźnie,
+    // stałe maski Sobela rozwinięte w czasie kompilacji
+    gradientX = Plane(plane.width(), plane.height());
+    gradientY = Plane(plane.width(), plane.height());
+    StaticConvolution::applyPlane<Masks::SobelX>(plane.data(), gradientX.data(), plane.width(), plane.height());
+    StaticConvolution::applyPlane<Masks::SobelY>(plane.data(), gradientY.data(), plane.width(), plane.height());
 }
 
-void Canny::step4_computeMagnitudeAndDirection(const std::vector<std::vector<double>>& gradientX,
-                                              const std::vector<std::vector<double>>& gradientY,
-                                              std::vector<std::vector<double>>& magnitude,
-                                              std::vector<std::vector<double>>& direction) {
-    int width = gradientX.size();
-    int height = gradientX[0].size();
+void Canny::step4_computeMagnitudeAndDirection(const Plane& gradientX, const Plane& gradientY,
+                                              Plane& magnitude, Plane& direction) {
+    int width = gradientX.width();
+    int height = gradientX.height();
     
-    // Inicjalizacja tablic
-    magnitude.assign(width, std::vector<double>(height, 0.0));
-    direction.assign(width, std::vector<double>(height, 0.0));
+    // Inicjalizacja płaszczyzn
+    magnitude = Plane(width, height);
+    direction = Plane(width, height);
     
-    for (int x = 0; x < width; x++) {
-        for (int y = 0; y < height; y++) {
-            double gx = gradientX[x][y];
-            double gy = gradientY[x][y];
-            
-            // Obliczenie magnitude: mij = √(Gx² + Gy²)
-            magnitude[x][y] = std::sqrt(gx * gx + gy * gy);
-            
-            // Obliczenie kierunku: θij = arctan(Gy/Gx)
-            direction[x][y] = std::atan2(gy, gx) * 180.0 / M_PI; // w stopniach
+    Parallel::forRange(height, [&](int begin, int end) {
+        for (int y = begin; y < end; y++) {
+            const float* gxRow = gradientX.row(y);
+            const float* gyRow = gradientY.row(y);
+            float* magnitudeRow = magnitude.row(y);
+            float* directionRow = direction.row(y);
+            for (int x = 0; x < width; x++) {
+                float gx = gxRow[x];
+                float gy = gyRow[x];
+                
+                // Obliczenie magnitude: mij = √(Gx² + Gy²)
+                magnitudeRow[x] = std::sqrt(gx * gx + gy * gy);
+                
+                // Obliczenie kierunku: θij = arctan(Gy/Gx)
+                directionRow[x] = std::atan2(gy, gx) * static_cast<float>(180.0 / M_PI); // w stopniach
+            }
         }
-    }
+    });
 }
 
-void Canny::step5_nonMaximumSuppression(const std::vector<std::vector<double>>& magnitude,
-                                       const std::vector<std::vector<double>>& direction,
-                                       std::vector<std::vector<bool>>& strongEdges,
-                                       double upperThresh) {
-    int width = magnitude.size();
-    int height = magnitude[0].size();
+void Canny::step5_nonMaximumSuppression(const Plane& magnitude, const Plane& direction,
+                                       std::vector<uint8_t>& strongEdges, double upperThresh) {
+    int width = magnitude.width();
+    int height = magnitude.height();
     
-    strongEdges.assign(width, std::vector<bool>(height, false));
+    strongEdges.assign(magnitude.size(), 0);
     
-    for (int x = 1; x < width - 1; x++) {
-        for (int y = 1; y < height - 1; y++) {
-            double currentMagnitude = magnitude[x][y];
+    for (int y = 1; y < height - 1; y++) {
+        for (int x = 1; x < width - 1; x++) {
+            double currentMagnitude = magnitude.at(x, y);
             
             // 1. sprawdź, w którym z 4 możliwych kierunków jest gradient piksela (i,j)
-            int sector = getDirectionSector(direction[x][y]);
+            int sector = getDirectionSector(direction.at(x, y));
             
             // 2. wybierz sąsiadów piksela (i,j) będących na linii prostopadłej do kierunku gradientu
             auto neighbors = getNeighborsForDirection(sector);
@@ -158,30 +126,29 @@ void Canny::step5_nonMaximumSuppression(const std::vector<std::vector<double>>&
             // 3. jeżeli moc gradientu piksela (i,j) jest większa od mocy gradientów 
             //    odpowiadających mu sąsiadów oraz większa od upper-thresh, 
             //    to dodaj piksel (i,j) do początkowego zbioru krawędzi
-            if (currentMagnitude > magnitude[x1][y1] && 
-                currentMagnitude > magnitude[x2][y2] && 
+            if (currentMagnitude > magnitude.at(x1, y1) && 
+                currentMagnitude > magnitude.at(x2, y2) && 
                 currentMagnitude > upperThresh) {
-                strongEdges[x][y] = true;
+                strongEdges[static_cast<size_t>(y) * width + x] = 1;
             }
         }
     }
 }
 
-void Canny::step6_hysteresisThresholding(const std::vector<std::vector<double>>& magnitude,
-                                        const std::vector<std::vector<double>>& direction,
-                                        const std::vector<std::vector<bool>>& strongEdges,
-                                        std::vector<std::vector<bool>>& finalEdges,
-                                        double lowerThresh) {
-    int width = magnitude.size();
-    int height = magnitude[0].size();
+void Canny::step6_hysteresisThresholding(const Plane& magnitude, const Plane& direction,
+                                        const std::vector<uint8_t>& strongEdges,
+                                        std::vector<uint8_t>& finalEdges, double lowerThresh) {
+    int width = magnitude.width();
+    int height = magnitude.height();
     
-    finalEdges.assign(width, std::vector<bool>(height, false));
-    std::vector<std::vector<bool>> visited(width, std::vector<bool>(height, false));
+    finalEdges.assign(magnitude.size(), 0);
+    std::vector<uint8_t> visited(magnitude.size(), 0);
+    auto index = [width](int x, int y) { return static_cast<size_t>(y) * width + x; };
     
     // Dla każdego piksela z początkowego zbioru krawędzi
-    for (int x = 0; x < width; x++) {
-        for (int y = 0; y < height; y++) {
-            if (strongEdges[x][y] && !visited[x][y]) {
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            if (strongEdges[index(x, y)] && !visited[index(x, y)]) {
                 // Użyj stosu do iteracyjnego śledzenia
                 std::stack<std::pair<int, int>> stack;
                 stack.push({x, y});
@@ -193,18 +160,18 @@ void Canny::step6_hysteresisThresholding(const std::vector<std::vector<double>>&
                     int cx = current.first;
                     int cy = current.second;
                     
-                    if (cx < 0 || cx >= width || cy < 0 || cy >= height || visited[cx][cy]) {
+                    if (cx < 0 || cx >= width || cy < 0 || cy >= height || visited[index(cx, cy)]) {
                         continue;
                     }
                     
-                    visited[cx][cy] = true;
-                    finalEdges[cx][cy] = true;
+                    visited[index(cx, cy)] = 1;
+                    finalEdges[index(cx, cy)] = 1;
                     
                     // Sprawdź osobno jego dwóch sąsiadów wyznaczonych przez kierunek gradientu
-                    int sector = getDirectionSector(direction[cx][cy]);
+                    int sector = getDirectionSector(direction.at(cx, cy));
                     auto neighbors = getNeighborsForDirection(sector);
                     
-                    std::vector<std::pair<int, int>> candidates = {
+                    std::pair<int, int> candidates[2] = {
                         {cx + neighbors.first.first, cy + neighbors.first.second},
                         {cx + neighbors.second.first, cy + neighbors.second.second}
                     };
@@ -213,13 +180,13 @@ void Canny::step6_hysteresisThresholding(const std::vector<std::vector<double>>&
                         int nx = candidate.first;
                         int ny = candidate.second;
                         
-                        if (nx >= 0 && nx < width && ny >= 0 && ny < height && !visited[nx][ny]) {
+                        if (nx >= 0 && nx < width && ny >= 0 && ny < height && !visited[index(nx, ny)]) {
 
                             // 1. moc gradientu większą od lower-thresh
-                            if (magnitude[nx][ny] >= lowerThresh) {
+                            if (magnitude.at(nx, ny) >= lowerThresh) {
                                 
                                 // 2. gradient skierowany w tę samą stronę co piksel, z którego przyszedł
-                                double dirDiff = std::abs(direction[nx][ny] - direction[cx][cy]);
+                                double dirDiff = std::abs(direction.at(nx, ny) - direction.at(cx, cy));
                                 if (dirDiff > 180) dirDiff = 360 - dirDiff; // normalizacja
                                 
                                 if (dirDiff <= 22.5) { // bardziej restrykcyjna tolerancja kierunku
@@ -228,7 +195,7 @@ void Canny::step6_hysteresisThresholding(const std::vector<std::vector<double>>&
                                     bool isLocalMaximum = true;
                                     
                                     // Sprawdź czy kandydat jest lokalnym maksimum w kierunku prostopadłym do gradientu
-                                    int candidateSector = getDirectionSector(direction[nx][ny]);
+                                    int candidateSector = getDirectionSector(direction.at(nx, ny));
                                     auto candidateNeighbors = getNeighborsForDirection(candidateSector);
                                     
                                     // Sprawdź dwóch sąsiadów prostopadłych do kierunku gradientu
@@ -239,12 +206,12 @@ void Canny::step6_hysteresisThresholding(const std::vector<std::vector<double>>&
                                     
                                     // Sprawdź granice i porównaj magnitude
                                     if (n1x >= 0 && n1x < width && n1y >= 0 && n1y < height) {
-                                        if (magnitude[nx][ny] <= magnitude[n1x][n1y]) {
+                                        if (magnitude.at(nx, ny) <= magnitude.at(n1x, n1y)) {
                                             isLocalMaximum = false;
                                         }
                                     }
                                     if (n2x >= 0 && n2x < width && n2y >= 0 && n2y < height) {
-                                        if (magnitude[nx][ny] <= magnitude[n2x][n2y]) {
+                                        if (magnitude.at(nx, ny) <= magnitude.at(n2x, n2y)) {
                                             isLocalMaximum = false;
                                         }
                                     }
@@ -264,24 +231,6 @@ void Canny::step6_hysteresisThresholding(const std::vector<std::vector<double>>&
 }
 
 // Funkcje pomocnicze
-std::pair<std::vector<std::vector<double>>, std::vector<std::vector<double>>> Canny::generateSobelKernels() {
-    // Operator Sobela - kierunek X (rawHorizontalDetection)
-    std::vector<std::vector<double>> sobelX = {
-        {-1, 0, 1},
-        {-2, 0, 2},
-        {-1, 0, 1}
-    };
-    
-    // Operator Sobela - kierunek Y (rawVerticalDetection)
-    std::vector<std::vector<double>> sobelY = {
-        {-1, -2, -1},
-        { 0,  0,  0},
-        { 1,  2,  1}
-    };
-    
-    return {sobelX, sobelY};
-}
-
 int Canny::getDirectionSector(double angle) {
     // Normalizacja kąta do zakresu [0, 180)
     while (angle < 0) angle += 180;
@@ -0,0 +1,204 @@
+#include "ColorLUT.h"
+#include "../core/PointOp.h"
+#include <QDebug>
+#include <QFile>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define COLORLUT_SSE2 1
+#endif
+
+ColorLUT::ColorLUT(int size) : m_size(std::clamp(size, 2, 256)) {
+    m_nodes.resize(static_cast<size_t>(m_size) * m_size * m_size * 4);
+    float step = 1.0f / (m_size - 1);
+    for (int b = 0; b < m_size; ++b) {
+        for (int g = 0; g < m_size; ++g) {
+            for (int r = 0; r < m_size; ++r) {
+                setNode(r, g, b, r * step, g * step, b * step);
+            }
+        }
+    }
+}
+
+void ColorLUT::setNode(int r, int g, int b, float outR, float outG, float outB) {
+    float* node = &m_nodes[nodeIndex(r, g, b)];
+    node[0] = outB * 255.0f;
+    node[1] = outG * 255.0f;
+    node[2] = outR * 255.0f;
+    node[3] = 255.0f;
+}
+
+bool ColorLUT::load(const QString& filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qDebug() << "Could not open file:" << filePath;
+        return false;
+    }
+
+    QTextStream in(&file);
+
+    int size = 0;
+    float domainMin[3] = {0.0f, 0.0f, 0.0f};
+    float domainMax[3] = {1.0f, 1.0f, 1.0f};
+    std::vector<float> values;
+
+    while (!in.atEnd()) {
+        QString line = in.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+
+        // Słowa kluczowe i liczby rozdzielone dowolnymi białymi znakami (spacje, tabulatory)
+        static const QRegularExpression whitespace("\\s+");
+        QStringList parts = line.split(whitespace, Qt::SkipEmptyParts);
+        const QString& keyword = parts[0];
+
+        // Wiersz danych zaczyna się liczbą, każdy inny wiersz to słowo kluczowe
+        bool numeric;
+        keyword.toFloat(&numeric);
+        if (numeric) {
+            // Wiersz danych: R G B
+            if (parts.size() != 3) {
+                qDebug() << "Invalid LUT entry:" << line;
+                return false;
+            }
+            for (const QString& part : parts) {
+                bool ok;
+                float value = part.toFloat(&ok);
+                if (!ok) {
+                    qDebug() << "Invalid LUT entry:" << line;
+                    return false;
+                }
+                values.push_back(value);
+            }
+        } else if (keyword == "LUT_3D_SIZE" && parts.size() == 2) {
+            size = parts[1].toInt();
+            if (size < 2 || size > 256) {
+                qDebug() << "Unsupported LUT_3D_SIZE:" << size;
+                return false;
+            }
+            values.reserve(static_cast<size_t>(size) * size * size * 3);
+        } else if ((keyword == "DOMAIN_MIN" || keyword == "DOMAIN_MAX") && parts.size() == 4) {
+            float* domain = keyword == "DOMAIN_MIN" ? domainMin : domainMax;
+            for (int c = 0; c < 3; ++c) {
+                domain[c] = parts[c + 1].toFloat();
+            }
+        } else if (keyword == "LUT_3D_INPUT_RANGE" && parts.size() == 3) {
+            // Wspólny zakres wejścia dla wszystkich kanałów (jak DOMAIN_MIN / DOMAIN_MAX)
+            for (int c = 0; c < 3; ++c) {
+                domainMin[c] = parts[1].toFloat();
+                domainMax[c] = parts[2].toFloat();
+            }
+        } else if (keyword == "LUT_1D_SIZE") {
+            qDebug() << "1D .cube files are not supported";
+            return false;
+        }
+        // Pozostałe słowa kluczowe (TITLE itp.) są pomijane
+    }
+
+    if (size == 0 || values.size() != static_cast<size_t>(size) * size * size * 3) {
+        qDebug() << "Invalid .cube file: expected" << size * size * size << "entries";
+        return false;
+    }
+    for (int c = 0; c < 3; ++c) {
+        if (domainMax[c] <= domainMin[c]) {
+            qDebug() << "Invalid .cube domain";
+            return false;
+        }
+    }
+
+    // W pliku .cube indeks czerwieni zmienia się najszybciej
+    m_size = size;
+    m_nodes.assign(static_cast<size_t>(size) * size * size * 4, 0.0f);
+    size_t i = 0;
+    for (int b = 0; b < size; ++b) {
+        for (int g = 0; g < size; ++g) {
+            for (int r = 0; r < size; ++r, i += 3) {
+                setNode(r, g, b, values[i], values[i + 1], values[i + 2]);
+            }
+        }
+    }
+    std::copy(domainMin, domainMin + 3, m_domainMin);
+    std::copy(domainMax, domainMax + 3, m_domainMax);
+
+    file.close();
+    return true;
+}
+
+void ColorLUT::apply(std::unique_ptr<Image>& image) const {
+    if (!image || !isValid()) {
+        return;
+    }
+
+    // Dla każdej wartości wejściowej kanału: przesunięcie węzła bazowego i część ułamkowa.
+    // Kanały w kolejności R, G, B; kroki siatki odpowiadają nodeIndex().
+    struct Axis {
+        std::array<int, 256> offset;
+        std::array<float, 256> fraction;
+    };
+    std::array<Axis, 3> axes;
+    const int strides[3] = {4, m_size * 4, m_size * m_size * 4};
+
+    for (int c = 0; c < 3; ++c) {
+        float scale = (m_size - 1) / (m_domainMax[c] - m_domainMin[c]);
+        for (int v = 0; v < 256; ++v) {
+            float t = std::clamp((v / 255.0f - m_domainMin[c]) * scale, 0.0f, static_cast<float>(m_size - 1));
+            int base = std::min(static_cast<int>(t), m_size - 2);
+            axes[c].offset[v] = base * strides[c];
+            axes[c].fraction[v] = t - base;
+        }
+    }
+
+    const float* nodes = m_nodes.data();
+    const int diagonal = strides[0] + strides[1] + strides[2];
+
+    PointOp::apply(image->bits(), image->width(), image->height(), [&](uint32_t* row, int count) {
+        for (int x = 0; x < count; ++x) {
+            uint32_t p = row[x];
+            int r = (p >> 16) & 0xFF;
+            int g = (p >> 8) & 0xFF;
+            int b = p & 0xFF;
+
+            float f[3] = {axes[0].fraction[r], axes[1].fraction[g], axes[2].fraction[b]};
+            const float* c0 = nodes + axes[0].offset[r] + axes[1].offset[g] + axes[2].offset[b];
+
+            // Wybór czworościanu: osie w kolejności malejących części ułamkowych
+            int a1 = 0, a2 = 1, a3 = 2;
+            if (f[a1] < f[a2]) std::swap(a1, a2);
+            if (f[a2] < f[a3]) std::swap(a2, a3);
+            if (f[a1] < f[a2]) std::swap(a1, a2);
+
+            const float* c1 = c0 + strides[a1];
+            const float* c2 = c1 + strides[a2];
+            const float* c3 = c0 + diagonal;
+            float w0 = 1.0f - f[a1];
+            float w1 = f[a1] - f[a2];
+            float w2 = f[a2] - f[a3];
+            float w3 = f[a3];
+
+#ifdef COLORLUT_SSE2
+            // Wszystkie cztery kanały węzła w jednym rejestrze
+            __m128 out = _mm_mul_ps(_mm_loadu_ps(c0), _mm_set1_ps(w0));
+            out = _mm_add_ps(out, _mm_mul_ps(_mm_loadu_ps(c1), _mm_set1_ps(w1)));
+            out = _mm_add_ps(out, _mm_mul_ps(_mm_loadu_ps(c2), _mm_set1_ps(w2)));
+            out = _mm_add_ps(out, _mm_mul_ps(_mm_loadu_ps(c3), _mm_set1_ps(w3)));
+            // Zaokrąglenie jak w wersji skalarnej: obcięcie do 0-255, potem +0.5 i odcięcie części ułamkowej
+            out = _mm_min_ps(_mm_max_ps(out, _mm_setzero_ps()), _mm_set1_ps(255.0f));
+            __m128i packed = _mm_packs_epi32(_mm_cvttps_epi32(_mm_add_ps(out, _mm_set1_ps(0.5f))), _mm_setzero_si128());
+            row[x] = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(packed, packed)));
+#else
+            uint32_t result = 0;
+            for (int c = 0; c < 4; ++c) {
+                float value = w0 * c0[c] + w1 * c1[c] + w2 * c2[c] + w3 * c3[c];
+                result |= static_cast<uint32_t>(std::clamp(value, 0.0f, 255.0f) + 0.5f) << (8 * c);
+            }
+            row[x] = result;
+#endif
+        }
+    });
+}
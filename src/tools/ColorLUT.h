@@ -0,0 +1,42 @@
+#ifndef COLORLUT_H
+#define COLORLUT_H
+
+#include <memory>
+#include <vector>
+#include <QString>
+#include "../image/Image.h"
+
+// Trójwymiarowa tablica LUT (siatka N x N x N) - odwzorowanie kolorów między kanałami,
+// którego nie da się wyrazić osobnymi tablicami dla R, G i B
+class ColorLUT {
+public:
+    ColorLUT() = default;
+
+    // Tablica tożsamościowa o zadanym rozmiarze siatki
+    explicit ColorLUT(int size);
+
+    // Wczytanie pliku .cube (LUT_3D_SIZE, opcjonalnie DOMAIN_MIN / DOMAIN_MAX lub LUT_3D_INPUT_RANGE)
+    bool load(const QString& filePath);
+
+    // Ustawienie węzła siatki (wartości w zakresie 0-1)
+    void setNode(int r, int g, int b, float outR, float outG, float outB);
+
+    int size() const { return m_size; }
+    bool isValid() const { return m_size >= 2; }
+
+    // Zastosowanie tablicy do obrazu z interpolacją czworościenną
+    void apply(std::unique_ptr<Image>& image) const;
+
+private:
+    int m_size = 0;
+    float m_domainMin[3] = {0.0f, 0.0f, 0.0f};
+    float m_domainMax[3] = {1.0f, 1.0f, 1.0f};
+
+    // Węzły w kolejności (B, G, R, A), przeskalowane do 0-255 - po zaokrągleniu
+    // i spakowaniu wektor ma od razu układ QRgb
+    std::vector<float> m_nodes;
+
+    int nodeIndex(int r, int g, int b) const { return ((b * m_size + g) * m_size + r) * 4; }
+};
+
+#endif // COLORLUT_H
@@ -0,0 +1,188 @@
+#include "ColorMatrix.h"
+#include "../core/PointOp.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define COLORMATRIX_SSE2 1
+#endif
+
+namespace {
+
+constexpr int Shift = Luma::Shift;
+constexpr float FixedOne = 1 << Shift;
+
+uint32_t packPixel(int r, int g, int b) {
+    return 0xFF000000u
+         | (static_cast<uint32_t>(std::clamp(r, 0, 255)) << 16)
+         | (static_cast<uint32_t>(std::clamp(g, 0, 255)) << 8)
+         | static_cast<uint32_t>(std::clamp(b, 0, 255));
+}
+
+#ifdef COLORMATRIX_SSE2
+// Składa cztery piksele QRgb z kanałów w int32 (z nasyceniem do 0-255)
+inline __m128i packPixels(__m128i r, __m128i g, __m128i b) {
+    const __m128i alpha = _mm_set1_epi32(255);
+    // Bajty: b0..b3 r0..r3 g0..g3 a0..a3
+    __m128i planar = _mm_packus_epi16(_mm_packs_epi32(b, r), _mm_packs_epi32(g, alpha));
+    // Transpozycja 4x4 bajtów do układu b g r a
+    __m128i bgra = _mm_unpacklo_epi8(planar, _mm_srli_si128(planar, 8));
+    return _mm_unpacklo_epi16(bgra, _mm_srli_si128(bgra, 8));
+}
+#endif
+
+} // namespace
+
+ColorMatrix::ColorMatrix()
+    : m_matrix{{{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}}},
+      m_offset{0.0f, 0.0f, 0.0f} {}
+
+ColorMatrix::ColorMatrix(const Matrix& matrix, const Offset& offset)
+    : m_matrix(matrix), m_offset(offset) {}
+
+ColorMatrix ColorMatrix::greyscale(Luma::Weights weights) {
+    // Wagi Q14 z Luma podzielone przez 2^14 są dokładnie reprezentowalne,
+    // więc wynik jest identyczny z Luma::gray
+    Luma::FixedWeights w = Luma::fixedWeights(weights);
+    std::array<float, 3> row = {w.r / FixedOne, w.g / FixedOne, w.b / FixedOne};
+    return ColorMatrix({row, row, row});
+}
+
+ColorMatrix ColorMatrix::sepia() {
+    return ColorMatrix({{{0.393f, 0.769f, 0.189f},
+                         {0.349f, 0.686f, 0.168f},
+                         {0.272f, 0.534f, 0.131f}}});
+}
+
+ColorMatrix ColorMatrix::whiteBalance(float gainR, float gainG, float gainB) {
+    return ColorMatrix({{{gainR, 0.0f, 0.0f},
+                         {0.0f, gainG, 0.0f},
+                         {0.0f, 0.0f, gainB}}});
+}
+
+ColorMatrix ColorMatrix::then(const ColorMatrix& next) const {
+    Matrix matrix{};
+    Offset offset{};
+    for (int i = 0; i < 3; ++i) {
+        offset[i] = next.m_offset[i];
+        for (int j = 0; j < 3; ++j) {
+            for (int k = 0; k < 3; ++k) {
+                matrix[i][j] += next.m_matrix[i][k] * m_matrix[k][j];
+            }
+            offset[i] += next.m_matrix[i][j] * m_offset[j];
+        }
+    }
+    return ColorMatrix(matrix, offset);
+}
+
+bool ColorMatrix::fitsFixedPoint() const {
+    for (const auto& row : m_matrix) {
+        for (float value : row) {
+            if (std::abs(value) * FixedOne > 32767.0f) {
+                return false;
+            }
+        }
+    }
+    for (float value : m_offset) {
+        if (std::abs(value) > 1024.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ColorMatrix::apply(std::unique_ptr<Image>& image) const {
+    if (!image) {
+        return;
+    }
+
+    if (fitsFixedPoint()) {
+        // Ścieżka całkowitoliczbowa: współczynniki Q14, offset i zaokrąglenie w int32
+        int coef[3][3];
+        int bias[3];
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                coef[i][j] = static_cast<int>(std::lround(m_matrix[i][j] * FixedOne));
+            }
+            bias[i] = static_cast<int>(std::lround(m_offset[i] * FixedOne)) + (1 << (Shift - 1));
+        }
+
+        PointOp::apply(image->bits(), image->width(), image->height(), [&](uint32_t* row, int count) {
+            int x = 0;
+#ifdef COLORMATRIX_SSE2
+            // Pary int16 (B, R) i (G, 0) w każdym pikselu - dwa _mm_madd_epi16 na kanał wyjściowy
+            __m128i weightsBR[3], weightsG[3], biasV[3];
+            for (int i = 0; i < 3; ++i) {
+                weightsBR[i] = _mm_set1_epi32((coef[i][0] << 16) | (coef[i][2] & 0xFFFF));
+                weightsG[i] = _mm_set1_epi32(coef[i][1] & 0xFFFF);
+                biasV[i] = _mm_set1_epi32(bias[i]);
+            }
+            const __m128i byteMask = _mm_set1_epi32(0x00FF00FF);
+            const __m128i lowMask = _mm_set1_epi32(0x000000FF);
+
+            for (; x + 4 <= count; x += 4) {
+                __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+                __m128i br = _mm_and_si128(pixels, byteMask);
+                __m128i g = _mm_and_si128(_mm_srli_epi32(pixels, 8), lowMask);
+                __m128i out[3];
+                for (int i = 0; i < 3; ++i) {
+                    __m128i sum = _mm_add_epi32(_mm_madd_epi16(br, weightsBR[i]), _mm_madd_epi16(g, weightsG[i]));
+                    out[i] = _mm_srai_epi32(_mm_add_epi32(sum, biasV[i]), Shift);
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(row + x), packPixels(out[0], out[1], out[2]));
+            }
+#endif
+            for (; x < count; ++x) {
+                uint32_t p = row[x];
+                int r = (p >> 16) & 0xFF;
+                int g = (p >> 8) & 0xFF;
+                int b = p & 0xFF;
+                int out[3];
+                for (int i = 0; i < 3; ++i) {
+                    out[i] = (r * coef[i][0] + g * coef[i][1] + b * coef[i][2] + bias[i]) >> Shift;
+                }
+                row[x] = packPixel(out[0], out[1], out[2]);
+            }
+        });
+        return;
+    }
+
+    // Ścieżka zmiennoprzecinkowa dla dużych współczynników
+    PointOp::apply(image->bits(), image->width(), image->height(), [this](uint32_t* row, int count) {
+        int x = 0;
+#ifdef COLORMATRIX_SSE2
+        const __m128i lowMask = _mm_set1_epi32(0x000000FF);
+        const __m128 low = _mm_set1_ps(-1.0f);
+        const __m128 high = _mm_set1_ps(256.0f);
+        for (; x + 4 <= count; x += 4) {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+            __m128 r = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 16), lowMask));
+            __m128 g = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 8), lowMask));
+            __m128 b = _mm_cvtepi32_ps(_mm_and_si128(pixels, lowMask));
+            __m128i out[3];
+            for (int i = 0; i < 3; ++i) {
+                __m128 sum = _mm_add_ps(_mm_mul_ps(r, _mm_set1_ps(m_matrix[i][0])),
+                                        _mm_mul_ps(g, _mm_set1_ps(m_matrix[i][1])));
+                sum = _mm_add_ps(sum, _mm_mul_ps(b, _mm_set1_ps(m_matrix[i][2])));
+                sum = _mm_add_ps(sum, _mm_set1_ps(m_offset[i]));
+                out[i] = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(sum, low), high));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(row + x), packPixels(out[0], out[1], out[2]));
+        }
+#endif
+        for (; x < count; ++x) {
+            uint32_t p = row[x];
+            float r = static_cast<float>((p >> 16) & 0xFF);
+            float g = static_cast<float>((p >> 8) & 0xFF);
+            float b = static_cast<float>(p & 0xFF);
+            int out[3];
+            for (int i = 0; i < 3; ++i) {
+                float value = r * m_matrix[i][0] + g * m_matrix[i][1] + b * m_matrix[i][2] + m_offset[i];
+                out[i] = static_cast<int>(std::lrint(std::clamp(value, -1.0f, 256.0f)));
+            }
+            row[x] = packPixel(out[0], out[1], out[2]);
+        }
+    });
+}
@@ -0,0 +1,41 @@
+#ifndef COLORMATRIX_H
+#define COLORMATRIX_H
+
+#include <array>
+#include <memory>
+#include "../image/Image.h"
+#include "../core/Luma.h"
+
+// Liniowe przekształcenie kolorów: [R' G' B'] = M * [R G B] + offset
+// (balans bieli, mieszanie kanałów, sepia, skala szarości) wykonywane w jednym przebiegu
+class ColorMatrix {
+public:
+    using Matrix = std::array<std::array<float, 3>, 3>;
+    using Offset = std::array<float, 3>;
+
+    // Macierz jednostkowa
+    ColorMatrix();
+    explicit ColorMatrix(const Matrix& matrix, const Offset& offset = {0.0f, 0.0f, 0.0f});
+
+    // Predefiniowane przekształcenia
+    static ColorMatrix greyscale(Luma::Weights weights = Luma::Weights::Legacy);
+    static ColorMatrix sepia();
+    static ColorMatrix whiteBalance(float gainR, float gainG, float gainB);
+
+    // Złożenie przekształceń: najpierw this, potem next (jeden przebieg zamiast dwóch)
+    ColorMatrix then(const ColorMatrix& next) const;
+
+    void apply(std::unique_ptr<Image>& image) const;
+
+    const Matrix& matrix() const { return m_matrix; }
+    const Offset& offset() const { return m_offset; }
+
+private:
+    Matrix m_matrix;
+    Offset m_offset; // w jednostkach 0-255
+
+    // Czy współczynniki mieszczą się w formacie Q14 (int16) - wtedy używana jest ścieżka całkowitoliczbowa
+    bool fitsFixedPoint() const;
+};
+
+#endif // COLORMATRIX_H
@@ -1,4 +1,8 @@
 #include "EdgeDetection.h"
+#include "../core/Convolution.h"
+#include "../core/Luma.h"
+#include "../core/Plane.h"
+#include "../core/StaticConvolution.h"
 #include <algorithm>
 #include <QColor>
 
@@ -6,6 +10,35 @@
 #define M_PI 3.14159265358979323846
 #endif
 
+namespace {
+
+// Luminancja BT.601 jako płaszczyzna float (bez zaokrąglania do 8 bitów) - wejście splotu LoG
+Plane luminancePlane(const std::unique_ptr<Image>& image) {
+    return Plane::fromLuma(image->constBits(), image->width(), image->height(), Luma::Weights::BT601);
+}
+
+// Laplasjany 3x3 i 5x5 to stałe maski - wersja rozwinięta w czasie kompilacji, arytmetyka
+// całkowita. Zwraca false dla innych rozmiarów (wtedy ogólny silnik splotu).
+bool applyStaticLaplacian(std::unique_ptr<Image>& image, int kernelSize, bool negative) {
+    uint32_t* pixels = image->bits();
+    int width = image->width();
+    int height = image->height();
+    auto output = Convolution::Output::Absolute;
+    if (kernelSize == 3) {
+        negative ? StaticConvolution::apply<Masks::LaplacianNegative3>(pixels, width, height, output)
+                 : StaticConvolution::apply<Masks::Laplacian3>(pixels, width, height, output);
+        return true;
+    }
+    if (kernelSize == 5) {
+        negative ? StaticConvolution::apply<Masks::LaplacianNegative5>(pixels, width, height, output)
+                 : StaticConvolution::apply<Masks::Laplacian5>(pixels, width, height, output);
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
 void EdgeDetection::laplacianFilter(std::unique_ptr<Image>& image, int kernelSize) {
     if (!image || kernelSize <= 0) {
         return;
@@ -21,6 +54,10 @@ void EdgeDetection::laplacianFilter(std::unique_ptr<Image>& image, int kernelSiz
         kernelSize = 3;
     }
     
+    if (applyStaticLaplacian(image, kernelSize, false)) {
+        return;
+    }
+    
     // Generowanie jądra Laplaciana
     auto kernel = generateLaplacianKernel(kernelSize);
     
@@ -55,67 +92,27 @@ void EdgeDetection::laplacianOfGaussianSimple(std::unique_ptr<Image>& image, dou
     auto logKernel = generateLoGKernel(sigma, kernelSize);
     
     // Aplikowanie prostej konwolucji z normalizacją
-    int width = image->width();
-    int height = image->height();
-    int kernelRadius = kernelSize / 2;
+    // Luminancja (BT.601) całego obrazu liczona raz, wektorowo, zamiast dla każdego elementu jądra
+    Plane luminance = luminancePlane(image);
     
-    // Tworzymy kopię oryginalnego obrazu
-    std::vector<std::vector<QColor>> originalPixels(width, std::vector<QColor>(height));
-    for (int x = 0; x < width; x++) {
-        for (int y = 0; y < height; y++) {
-            originalPixels[x][y] = image->pixelAt(x, y);
-        }
-    }
-    
-    // Obliczanie odpowiedzi LoG dla każdego piksela
-    std::vector<std::vector<double>> logResponse(width, std::vector<double>(height));
-    for (int x = 0; x < width; x++) {
-        for (int y = 0; y < height; y++) {
-            double sum = 0.0;
-            
-            for (int kx = 0; kx < kernelSize; kx++) {
-                for (int ky = 0; ky < kernelSize; ky++) {
-                    int pixelX = x + kx - kernelRadius;
-                    int pixelY = y + ky - kernelRadius;
-                    
-                    // Obsługa granic obrazu (odbicie)
-                    pixelX = std::max(0, std::min(width - 1, pixelX));
-                    pixelY = std::max(0, std::min(height - 1, pixelY));
-                    
-                    QColor pixel = originalPixels[pixelX][pixelY];
-                    // Konwersja na luminancję
-                    double luminance = 0.299 * pixel.red() + 0.587 * pixel.green() + 0.114 * pixel.blue();
-                    
-                    sum += luminance * logKernel[kx][ky];
-                }
-            }
-            
-            logResponse[x][y] = sum;
-        }
-    }
+    // Odpowiedź LoG - jądro ma rząd 2, więc liczone jako przebiegi 1D zamiast k² mnożeń na piksel
+    Plane logResponse = luminance.convolved(logKernel);
     
     // Znajdź zakres wartości dla normalizacji
-    double minResponse = logResponse[0][0];
-    double maxResponse = logResponse[0][0];
-    
-    for (int x = 0; x < width; x++) {
-        for (int y = 0; y < height; y++) {
-            minResponse = std::min(minResponse, logResponse[x][y]);
-            maxResponse = std::max(maxResponse, logResponse[x][y]);
-        }
-    }
+    auto [minIt, maxIt] = std::minmax_element(logResponse.data(), logResponse.data() + logResponse.size());
+    double minResponse = *minIt;
+    double maxResponse = *maxIt;
     
     // Normalizuj do zakresu 0-255
     double range = maxResponse - minResponse;
     if (range > 0) {
-        for (int x = 0; x < width; x++) {
-            for (int y = 0; y < height; y++) {
-                double normalizedValue = (logResponse[x][y] - minResponse) / range * 255.0;
-                int outputValue = clamp(static_cast<int>(normalizedValue));
-                
-                // Ustaw ten sam poziom dla wszystkich kanałów (obraz w skali szarości)
-                image->setPixel(x, y, outputValue, outputValue, outputValue);
-            }
+        uint32_t* pixels = image->bits();
+        for (size_t i = 0; i < logResponse.size(); i++) {
+            double normalizedValue = (logResponse.data()[i] - minResponse) / range * 255.0;
+            int outputValue = clamp(static_cast<int>(normalizedValue));
+            
+            // Ten sam poziom dla wszystkich kanałów (obraz w skali szarości)
+            pixels[i] = qRgb(outputValue, outputValue, outputValue);
         }
     }
 }
@@ -135,11 +132,8 @@ void EdgeDetection::laplacianFilterGrayscale(std::unique_ptr<Image>& image, int
         kernelSize = 3;
     }
     
-    // Generowanie jądra Laplaciana
-    auto kernel = generateLaplacianKernel(kernelSize);
-    
     // Aplikowanie konwolucji z konwersją na skalę szarości
-    applyLaplacianGrayscaleConvolution(image, kernel);
+    applyLaplacianGrayscaleConvolution(image, kernelSize);
 }
 
 void EdgeDetection::laplacianFilterNegative(std::unique_ptr<Image>& image, int kernelSize) {
@@ -157,6 +151,10 @@ void EdgeDetection::laplacianFilterNegative(std::unique_ptr<Image>& image, int k
         kernelSize = 3;
     }
     
+    if (applyStaticLaplacian(image, kernelSize, true)) {
+        return;
+    }
+    
     // Generowanie negatywnego jądra Laplaciana
     auto kernel = generateLaplacianNegativeKernel(kernelSize);
     
@@ -169,11 +167,8 @@ void EdgeDetection::robertsFilter(std::unique_ptr<Image>& image) {
         return;
     }
     
-    // Generowanie jąder Robertsa
-    auto robertsKernels = generateRobertsKernels();
-    
-    // Aplikowanie filtrów gradientowych
-    applyGradientConvolution(image, robertsKernels.first, robertsKernels.second);
+    // Aplikowanie filtrów gradientowych - stałe maski Robertsa, rozwinięte w czasie kompilacji
+    StaticConvolution::applyMagnitude<Masks::RobertsX, Masks::RobertsY>(image->bits(), image->width(), image->height());
 }
 
 void EdgeDetection::prewittFilter(std::unique_ptr<Image>& image) {
@@ -181,11 +176,8 @@ void EdgeDetection::prewittFilter(std::unique_ptr<Image>& image) {
         return;
     }
     
-    // Generowanie jąder Prewitta
-    auto prewittKernels = generatePrewittKernels();
-    
-    // Aplikowanie filtrów gradientowych
-    applyGradientConvolution(image, prewittKernels.first, prewittKernels.second);
+    // Aplikowanie filtrów gradientowych - stałe maski Prewitta, rozwinięte w czasie kompilacji
+    StaticConvolution::applyMagnitude<Masks::PrewittX, Masks::PrewittY>(image->bits(), image->width(), image->height());
 }
 
 void EdgeDetection::sobelFilter(std::unique_ptr<Image>& image) {
@@ -193,33 +185,31 @@ void EdgeDetection::sobelFilter(std::unique_ptr<Image>& image) {
         return;
     }
     
-    // Generowanie jąder Sobela
-    auto sobelKernels = generateSobelKernels();
-    
-    // Aplikowanie filtrów gradientowych
-    applyGradientConvolution(image, sobelKernels.first, sobelKernels.second);
+    // Aplikowanie filtrów gradientowych - stałe maski Sobela, rozwinięte w czasie kompilacji
+    StaticConvolution::applyMagnitude<Masks::SobelX, Masks::SobelY>(image->bits(), image->width(), image->height());
 }
 
-void EdgeDetection::customEdgeFilter(std::unique_ptr<Image>& image, const std::vector<std::vector<double>>& matrix) {
+std::string EdgeDetection::customEdgeFilter(std::unique_ptr<Image>& image, const std::vector<std::vector<double>>& matrix) {
     if (!image || matrix.empty() || matrix[0].empty()) {
-        return;
+        return {};
     }
     
     // Sprawdzenie czy macierz jest kwadratowa
     size_t size = matrix.size();
     for (const auto& row : matrix) {
         if (row.size() != size) {
-            return; // Macierz nie jest kwadratowa
+            return {}; // Macierz nie jest kwadratowa
         }
     }
     
     // Sprawdzenie czy rozmiar jest nieparzysty
     if (size % 2 == 0) {
-        return; // Rozmiar musi być nieparzysty
+        return {}; // Rozmiar musi być nieparzysty
     }
     
-    // Aplikowanie konwolucji z niestandardową macierzą
-    applyConvolution(image, matrix);
+    // Jądra separowalne (Sobel, Prewitt) i niskiego rzędu - przebiegi 1D, duże jądra - FFT
+    return Convolution::apply(image->bits(), image->width(), image->height(), matrix,
+                              Convolution::Output::Absolute);
 }
 
 std::vector<std::vector<double>> EdgeDetection::generateLaplacianKernel(int size) {
@@ -227,20 +217,11 @@ std::vector<std::vector<double>> EdgeDetection::generateLaplacianKernel(int size
     
     if (size == 3) {
         // Standard 3x3 Laplacian kernel (4-connected)
-        kernel = {
-            { 0, -1,  0},
-            {-1,  4, -1},
-            { 0, -1,  0}
-        };
+        kernel = Masks::Laplacian3.toMatrix();
     } else if (size == 5) {
         // 5x5 Laplacian kernel
-        kernel = {
-            { 0,  0, -1,  0,  0},
-            { 0, -1, -2, -1,  0},
-            {-1, -2, 16, -2, -1},
-            { 0, -1, -2, -1,  0},
-            { 0,  0, -1,  0,  0}
-        };    } else {
+        kernel = Masks::Laplacian5.toMatrix();
+    } else {
         // For other sizes, create basic Laplacian kernel
         int center = size / 2;
         
@@ -264,20 +245,10 @@ std::vector<std::vector<double>> EdgeDetection::generateLaplacianNegativeKernel(
     
     if (size == 3) {
         // Negative 3x3 Laplacian kernel (detects dark lines on bright background)
-        kernel = {
-            { 0,  1,  0},
-            { 1, -4,  1},
-            { 0,  1,  0}
-        };
+        kernel = Masks::LaplacianNegative3.toMatrix();
     } else if (size == 5) {
         // 5x5 Negative Laplacian kernel
-        kernel = {
-            { 0,  0,  1,  0,  0},
-            { 0,  1,  2,  1,  0},
-            { 1,  2,-16,  2,  1},
-            { 0,  1,  2,  1,  0},
-            { 0,  0,  1,  0,  0}
-        };
+        kernel = Masks::LaplacianNegative5.toMatrix();
     } else {
         // For other sizes, create negative Laplacian kernel
         int center = size / 2;
@@ -332,53 +303,16 @@ void EdgeDetection::applyLoGWithThresholding(std::unique_ptr<Image>& image, doub
     // Generowanie jądra Laplacian of Gaussian
     auto logKernel = generateLoGKernel(sigma, kernelSize);
     
-    // Aplikowanie konwolucji LoG
-    int kernelRadius = kernelSize / 2;
-    std::vector<std::vector<double>> logResponse(width, std::vector<double>(height));
+    // Luminancja (BT.601) całego obrazu liczona raz, wektorowo, zamiast dla każdego elementu jądra
+    Plane luminance = luminancePlane(image);
     
-    // Tworzymy kopię oryginalnego obrazu
-    std::vector<std::vector<QColor>> originalPixels(width, std::vector<QColor>(height));
-    for (int x = 0; x < width; x++) {
-        for (int y = 0; y < height; y++) {
-            originalPixels[x][y] = image->pixelAt(x, y);
-        }
-    }
+    // Aplikowanie konwolucji LoG (ścieżkę wybiera model kosztu w Convolution)
+    Plane logResponse = luminance.convolved(logKernel);
     
-    // Obliczanie odpowiedzi LoG dla każdego piksela
-    for (int x = 0; x < width; x++) {
-        for (int y = 0; y < height; y++) {
-            double sum = 0.0;
-            
-            for (int kx = 0; kx < kernelSize; kx++) {
-                for (int ky = 0; ky < kernelSize; ky++) {
-                    int pixelX = x + kx - kernelRadius;
-                    int pixelY = y + ky - kernelRadius;
-                    
-                    // Obsługa granic obrazu (odbicie)
-                    pixelX = std::max(0, std::min(width - 1, pixelX));
-                    pixelY = std::max(0, std::min(height - 1, pixelY));
-                    
-                    QColor pixel = originalPixels[pixelX][pixelY];
-                    // Konwersja na luminancję
-                    double luminance = 0.299 * pixel.red() + 0.587 * pixel.green() + 0.114 * pixel.blue();
-                    
-                    sum += luminance * logKernel[kx][ky];
-                }
-            }
-            
-            logResponse[x][y] = sum;
-        }
-    }
       // Krok 2: Znajdź zakres wartości LoG dla adaptacyjnego progowania
-    double minResponse = logResponse[0][0];
-    double maxResponse = logResponse[0][0];
-    
-    for (int x = 0; x < width; x++) {
-        for (int y = 0; y < height; y++) {
-            minResponse = std::min(minResponse, logResponse[x][y]);
-            maxResponse = std::max(maxResponse, logResponse[x][y]);
-        }
-    }
+    auto [minIt, maxIt] = std::minmax_element(logResponse.data(), logResponse.data() + logResponse.size());
+    double minResponse = *minIt;
+    double maxResponse = *maxIt;
       // Oblicz adaptacyjny próg na podstawie zakresu wartości i parametru threshold
     double range = maxResponse - minResponse;
     double adaptiveThreshold = range * threshold; // threshold jako procent zakresu
@@ -388,7 +322,7 @@ void EdgeDetection::applyLoGWithThresholding(std::unique_ptr<Image>& image, doub
     // Krok 3: Dla każdego piksela (i,j) - progowanie zgodnie z algorytmem
     for (int x = 0; x < width; x++) {
         for (int y = 0; y < height; y++) {
-            double currentValue = logResponse[x][y];
+            double currentValue = logResponse.at(x, y);
             
             // Pobierz okno z laplasjanu gaussowskiego
             double minVal = currentValue;
@@ -399,7 +333,7 @@ void EdgeDetection::applyLoGWithThresholding(std::unique_ptr<Image>& image, doub
                     int nx = std::max(0, std::min(width - 1, x + wx));
                     int ny = std::max(0, std::min(height - 1, y + wy));
                     
-                    double val = logResponse[nx][ny];
+                    double val = logResponse.at(nx, ny);
                     minVal = std::min(minVal, val);
                     maxVal = std::max(maxVal, val);
                 }
@@ -423,241 +357,37 @@ void EdgeDetection::applyLoGWithThresholding(std::unique_ptr<Image>& image, doub
 }
 
 std::pair<std::vector<std::vector<double>>, std::vector<std::vector<double>>> EdgeDetection::generateRobertsKernels() {
-    // Operator Robertsa X (ukośne krawędzie)
-    std::vector<std::vector<double>> robertsX = {
-        {1, 0},
-        {0, -1}
-    };
-    
-    // Operator Robertsa Y (ukośne krawędzie)
-    std::vector<std::vector<double>> robertsY = {
-        {0, 1},
-        {-1, 0}
-    };
-    
-    return std::make_pair(robertsX, robertsY);
+    // Operator Robertsa X i Y (ukośne krawędzie)
+    return std::make_pair(Masks::RobertsX.toMatrix(), Masks::RobertsY.toMatrix());
 }
 
 std::pair<std::vector<std::vector<double>>, std::vector<std::vector<double>>> EdgeDetection::generatePrewittKernels() {
-    // Operator Prewitta X (pionowe krawędzie)
-    std::vector<std::vector<double>> prewittX = {
-        {-1, 0, 1},
-        {-1, 0, 1},
-        {-1, 0, 1}
-    };
-    
-    // Operator Prewitta Y (poziome krawędzie)
-    std::vector<std::vector<double>> prewittY = {
-        {-1, -1, -1},
-        { 0,  0,  0},
-        { 1,  1,  1}
-    };
-    
-    return std::make_pair(prewittX, prewittY);
+    // Operator Prewitta X (pionowe krawędzie) i Y (poziome krawędzie)
+    return std::make_pair(Masks::PrewittX.toMatrix(), Masks::PrewittY.toMatrix());
 }
 
 std::pair<std::vector<std::vector<double>>, std::vector<std::vector<double>>> EdgeDetection::generateSobelKernels() {
-    // Operator Sobela X (pionowe krawędzie)
-    std::vector<std::vector<double>> sobelX = {
-        {-1, 0, 1},
-        {-2, 0, 2},
-        {-1, 0, 1}
-    };
-    
-    // Operator Sobela Y (poziome krawędzie)
-    std::vector<std::vector<double>> sobelY = {
-        {-1, -2, -1},
-        { 0,  0,  0},
-        { 1,  2,  1}
-    };
-    
-    return std::make_pair(sobelX, sobelY);
+    // Operator Sobela X (pionowe krawędzie) i Y (poziome krawędzie)
+    return std::make_pair(Masks::SobelX.toMatrix(), Masks::SobelY.toMatrix());
 }
 
 void EdgeDetection::applyConvolution(std::unique_ptr<Image>& image, const std::vector<std::vector<double>>& kernel) {
-    int width = image->width();
-    int height = image->height();
-    int kernelSize = kernel.size();
-    int kernelRadius = kernelSize / 2;
-    
-    // Tworzymy kopię oryginalnego obrazu do odczytu wartości
-    std::vector<std::vector<QColor>> originalPixels(width, std::vector<QColor>(height));
-    for (int x = 0; x < width; x++) {
-        for (int y = 0; y < height; y++) {
-            originalPixels[x][y] = image->pixelAt(x, y);
-        }
-    }
-    
-    // Aplikowanie konwolucji
-    for (int x = 0; x < width; x++) {
-        for (int y = 0; y < height; y++) {
-            double newR = 0.0, newG = 0.0, newB = 0.0;
-            
-            // Iteracja przez jądro
-            for (int kx = 0; kx < kernelSize; kx++) {
-                for (int ky = 0; ky < kernelSize; ky++) {
-                    int pixelX = x + kx - kernelRadius;
-                    int pixelY = y + ky - kernelRadius;
-                    
-                    // Obsługa pikseli poza granicami obrazu (odbicie)
-                    pixelX = std::max(0, std::min(width - 1, pixelX));
-                    pixelY = std::max(0, std::min(height - 1, pixelY));
-                    
-                    QColor pixel = originalPixels[pixelX][pixelY];
-                    double kernelValue = kernel[kx][ky];
-                    
-                    newR += pixel.red() * kernelValue;
-                    newG += pixel.green() * kernelValue;
-                    newB += pixel.blue() * kernelValue;
-                }
-            }
-              // Dla operatora Laplace'a bierzemy wartość absolutną dla lepszej wizualizacji
-            newR = std::abs(newR);
-            newG = std::abs(newG);
-            newB = std::abs(newB);
-            
-            // Opcjonalnie: przekształcenie na skalę szarości dla lepszej wizualizacji krawędzi
-            // double magnitude = 0.299 * newR + 0.587 * newG + 0.114 * newB;
-            // image->setPixel(x, y, clamp(static_cast<int>(magnitude)),
-            //                      clamp(static_cast<int>(magnitude)),
-            //                      clamp(static_cast<int>(magnitude)));
-            
-            // Ograniczenie wartości do zakresu 0-255 i ustawienie nowego piksela
-            image->setPixel(x, y, clamp(static_cast<int>(newR)),
-                                 clamp(static_cast<int>(newG)),
-                                 clamp(static_cast<int>(newB)));
-        }
-    }
-}
-
-void EdgeDetection::applyLaplacianGrayscaleConvolution(std::unique_ptr<Image>& image, const std::vector<std::vector<double>>& kernel) {
-    int width = image->width();
-    int height = image->height();
-    int kernelSize = kernel.size();
-    int kernelRadius = kernelSize / 2;
-    
-    // Tworzymy kopię oryginalnego obrazu do odczytu wartości
-    std::vector<std::vector<QColor>> originalPixels(width, std::vector<QColor>(height));
-    for (int x = 0; x < width; x++) {
-        for (int y = 0; y < height; y++) {
-            originalPixels[x][y] = image->pixelAt(x, y);
-        }
-    }
-    
-    // Aplikowanie konwolucji
-    for (int x = 0; x < width; x++) {
-        for (int y = 0; y < height; y++) {
-            double newR = 0.0, newG = 0.0, newB = 0.0;
-            
-            // Iteracja przez jądro
-            for (int kx = 0; kx < kernelSize; kx++) {
-                for (int ky = 0; ky < kernelSize; ky++) {
-                    int pixelX = x + kx - kernelRadius;
-                    int pixelY = y + ky - kernelRadius;
-                    
-                    // Obsługa pikseli poza granicami obrazu (odbicie)
-                    pixelX = std::max(0, std::min(width - 1, pixelX));
-                    pixelY = std::max(0, std::min(height - 1, pixelY));
-                    
-                    QColor pixel = originalPixels[pixelX][pixelY];
-                    double kernelValue = kernel[kx][ky];
-                    
-                    newR += pixel.red() * kernelValue;
-                    newG += pixel.green() * kernelValue;
-                    newB += pixel.blue() * kernelValue;
-                }
-            }
-            
-            // Obliczenie magnitude dla każdego kanału i konwersja na skalę szarości
-            double magnitudeR = std::abs(newR);
-            double magnitudeG = std::abs(newG);
-            double magnitudeB = std::abs(newB);
-            
-            // Konwersja na skalę szarości używając luminancji
-            double magnitude = 0.299 * magnitudeR + 0.587 * magnitudeG + 0.114 * magnitudeB;
-            int grayValue = clamp(static_cast<int>(magnitude));
-            
-            // Ustawienie tego samego poziomu szarości dla wszystkich kanałów
-            image->setPixel(x, y, grayValue, grayValue, grayValue);
-        }
-    }
+    // Dla operatora Laplace'a bierzemy wartość absolutną dla lepszej wizualizacji
+    Convolution::apply(image->bits(), image->width(), image->height(), kernel, Convolution::Output::Absolute);
 }
 
-void EdgeDetection::applyGradientConvolution(std::unique_ptr<Image>& image, 
-                                            const std::vector<std::vector<double>>& kernelX,
-                                            const std::vector<std::vector<double>>& kernelY) {
-    int width = image->width();
-    int height = image->height();
-    int kernelSizeX = kernelX.size();
-    int kernelSizeY = kernelY.size();
-    int kernelRadiusX = kernelSizeX / 2;
-    int kernelRadiusY = kernelSizeY / 2;
-    
-    // Tworzymy kopię oryginalnego obrazu do odczytu wartości
-    std::vector<std::vector<QColor>> originalPixels(width, std::vector<QColor>(height));
-    for (int x = 0; x < width; x++) {
-        for (int y = 0; y < height; y++) {
-            originalPixels[x][y] = image->pixelAt(x, y);
-        }
-    }
-    
-    // Aplikowanie konwolucji gradientowej zgodnie z dokumentacją
-    for (int x = 0; x < width; x++) {
-        for (int y = 0; y < height; y++) {
-            // Image_x = horizontalDetection() - gradient po x
-            double gxR = 0.0, gxG = 0.0, gxB = 0.0;
-            // Image_y = verticalDetection() - gradient po y  
-            double gyR = 0.0, gyG = 0.0, gyB = 0.0;
-            
-            // Iteracja przez jądro X
-            for (int kx = 0; kx < kernelSizeX; kx++) {
-                for (int ky = 0; ky < kernelSizeX; ky++) {
-                    int pixelX = x + kx - kernelRadiusX;
-                    int pixelY = y + ky - kernelRadiusX;
-                    
-                    // Obsługa pikseli poza granicami obrazu (odbicie)
-                    pixelX = std::max(0, std::min(width - 1, pixelX));
-                    pixelY = std::max(0, std::min(height - 1, pixelY));
-                    
-                    QColor pixel = originalPixels[pixelX][pixelY];
-                    double kernelXValue = kernelX[kx][ky];
-                    double kernelYValue = kernelY[kx][ky];
-
-                    gxR += pixel.red() * kernelXValue;
-                    gxG += pixel.green() * kernelXValue;
-                    gxB += pixel.blue() * kernelXValue;
-                }
-            }
-            
-            // Iteracja przez jądro Y
-            for (int kx = 0; kx < kernelSizeY; kx++) {
-                for (int ky = 0; ky < kernelSizeY; ky++) {
-                    int pixelX = x + kx - kernelRadiusY;
-                    int pixelY = y + ky - kernelRadiusY;
-                    
-                    // Obsługa pikseli poza granicami obrazu (odbicie)
-                    pixelX = std::max(0, std::min(width - 1, pixelX));
-                    pixelY = std::max(0, std::min(height - 1, pixelY));
-                    
-                    QColor pixel = originalPixels[pixelX][pixelY];
-                    double kernelYValue = kernelY[kx][ky];
-                    
-                    gyR += pixel.red() * kernelYValue;
-                    gyG += pixel.green() * kernelYValue;
-                    gyB += pixel.blue() * kernelYValue;
-                }
-            }
-            
-            // Obliczenie magnitude gradientu: I_new(i,j) := √(Image_x(i,j)² + Image_y(i,j)²)
-            double magnitudeR = std::sqrt(gxR * gxR + gyR * gyR);
-            double magnitudeG = std::sqrt(gxG * gxG + gyG * gyG);
-            double magnitudeB = std::sqrt(gxB * gxB + gyB * gyB);
-            
-            // Ograniczenie wartości do zakresu 0-255 i ustawienie nowego piksela
-            image->setPixel(x, y, clamp(static_cast<int>(magnitudeR)),
-                                 clamp(static_cast<int>(magnitudeG)),
-                                 clamp(static_cast<int>(magnitudeB)));
-        }
+void EdgeDetection::applyLaplacianGrayscaleConvolution(std::unique_ptr<Image>& image, int kernelSize) {
+    // Moduł odpowiedzi dla każdego kanału
+    if (!applyStaticLaplacian(image, kernelSize, false)) {
+        applyConvolution(image, generateLaplacianKernel(kernelSize));
+    }
+    
+    // Konwersja na skalę szarości używając luminancji i ten sam poziom dla wszystkich kanałów
+    std::vector<uint8_t> gray(image->pixelCount());
+    Luma::toGray(image->constBits(), gray.data(), gray.size(), Luma::Weights::BT601);
+    uint32_t* pixels = image->bits();
+    for (size_t i = 0; i < gray.size(); i++) {
+        pixels[i] = qRgb(gray[i], gray[i], gray[i]);
     }
 }
 
@@ -5,6 +5,7 @@
 #include "Canny.h"
 #include <cmath>
 #include <memory>
+#include <string>
 #include <vector>
 
 class EdgeDetection {
@@ -41,9 +42,10 @@ public:
     Canny::applyCanny(image, upperThresh, lowerThresh);
   }
 
-  // Filtr wykrywania krawędzi z macierzą niestandardową
-  static void customEdgeFilter(std::unique_ptr<Image> &image,
-                               const std::vector<std::vector<double>> &matrix);
+  // Filtr wykrywania krawędzi z macierzą niestandardową; ścieżkę (splot 2D, przebiegi 1D
+  // lub FFT) wybiera Convolution::plan. Zwraca opis wybranej ścieżki (pusty przy błędzie).
+  static std::string customEdgeFilter(std::unique_ptr<Image> &image,
+                                      const std::vector<std::vector<double>> &matrix);
 
   // Generowanie jądra Laplaciana
   static std::vector<std::vector<double>> generateLaplacianKernel(int size);
@@ -61,7 +63,7 @@ private:
                                        double sigma, int windowSize,
                                        double threshold);
 
-  // Generowanie jąder gradientowych
+  // Generowanie jąder gradientowych (macierze stałych masek z StaticConvolution.h)
   static std::pair<std::vector<std::vector<double>>,
                    std::vector<std::vector<double>>>
   generateRobertsKernels();
@@ -72,20 +74,13 @@ private:
                    std::vector<std::vector<double>>>
   generateSobelKernels();
 
-  // Aplikowanie konwolucji gradientowej
-  static void
-  applyGradientConvolution(std::unique_ptr<Image> &image,
-                           const std::vector<std::vector<double>> &kernelX,
-                           const std::vector<std::vector<double>> &kernelY);
-
-  // Aplikowanie konwolucji do obrazu (współdzielone z Blur)
+  // Aplikowanie konwolucji do obrazu (moduł wyniku, Convolution::Output::Absolute)
   static void applyConvolution(std::unique_ptr<Image> &image,
                                const std::vector<std::vector<double>> &kernel);
 
   // Aplikowanie konwolucji Laplaciana z konwersją na skalę szarości
-  static void applyLaplacianGrayscaleConvolution(
-      std::unique_ptr<Image> &image,
-      const std::vector<std::vector<double>> &kernel);
+  static void applyLaplacianGrayscaleConvolution(std::unique_ptr<Image> &image,
+                                                 int kernelSize);
 
   // Funkcja pomocnicza do ograniczania wartości
   static int clamp(int value, int min = 0, int max = 255);
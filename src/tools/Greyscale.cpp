@@ -1,23 +1,13 @@
 #include "Greyscale.h"
+#include "ColorMatrix.h"
 #include <QDebug>
 #include <algorithm>
 #include <cmath>
 
-void Greyscale::convertToGreyscale(std::unique_ptr<Image> &image) {
-  int width = image->width();
-  int height = image->height();
-
-  for (int y = 0; y < height; ++y) {
-    for (int x = 0; x < width; ++x) {
-      int r = image->getPixelR(x, y);
-      int g = image->getPixelG(x, y);
-      int b = image->getPixelB(x, y);
-
-      int gray = static_cast<int>(0.3 * r + 0.6 * g + 0.1 * b);
-
-      image->setPixel(x, y, gray, gray, gray);
-    }
-  }
+void Greyscale::convertToGreyscale(std::unique_ptr<Image> &image,
+                                   Luma::Weights weights) {
+  // Skala szarości to macierz kolorów o trzech identycznych wierszach wag luminancji
+  ColorMatrix::greyscale(weights).apply(image);
 }
 
 void Greyscale::adjustBrightness(std::unique_ptr<Image> &image, float value) {
@@ -94,23 +84,11 @@ std::array<int, 256> Greyscale::createGammaLUT(float gamma) {
 
 void Greyscale::applyLUT(std::unique_ptr<Image> &image,
                          const std::array<int, 256> &lut) {
-  int width = image->width();
-  int height = image->height();
-
-  for (int y = 0; y < height; ++y) {
-    for (int x = 0; x < width; ++x) {
-      // Pobierz wartości RGB
-      int r = image->getPixelR(x, y);
-      int g = image->getPixelG(x, y);
-      int b = image->getPixelB(x, y);
-
-      // Zastosuj LUT do każdego kanału
-      r = lut[r];
-      g = lut[g];
-      b = lut[b];
-
-      // Ustaw nowe wartości
-      image->setPixel(x, y, r, g, b);
-    }
+  // Ta sama tablica dla wszystkich kanałów, zawężona do bajtów
+  std::array<uint8_t, 256> table;
+  for (int i = 0; i < 256; ++i) {
+    table[i] = static_cast<uint8_t>(std::clamp(lut[i], 0, 255));
   }
-}
\ No newline at end of file
+
+  image->applyLUT(table.data(), table.data(), table.data());
+}
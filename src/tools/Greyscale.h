@@ -4,11 +4,13 @@
 #include <memory>
 #include <array>
 #include "../image/Image.h"
+#include "../core/Luma.h"
 
 class Greyscale {
 public:
-  // Konwersja do skali szarości
-  static void convertToGreyscale(std::unique_ptr<Image>& image);
+  // Konwersja do skali szarości (domyślnie historyczne wagi 0.3/0.6/0.1)
+  static void convertToGreyscale(std::unique_ptr<Image>& image,
+                                 Luma::Weights weights = Luma::Weights::Legacy);
 
   // Funkcje modyfikujące obraz przy użyciu LUT
   static void adjustBrightness(std::unique_ptr<Image>& image, float value);
@@ -1,42 +1,39 @@
 #include "Histogram.h"
+#include "../core/Parallel.h"
 #include <algorithm>
 #include <cmath>
 
-std::array<int, 256> Histogram::calculateHistogram(const std::unique_ptr<Image>& image, Channel channel) {
-    std::array<int, 256> histogram{};
-    histogram.fill(0);
+std::array<int, 256> Histogram::calculateHistogram(const std::unique_ptr<Image>& image, Channel channel, Mode mode) {
+    auto histograms = calculateHistograms(image, mode);
     
-    int width = image->width();
-    int height = image->height();
+    switch (channel) {
+        case Channel::RED:
+            return histograms.red;
+        case Channel::GREEN:
+            return histograms.green;
+        case Channel::BLUE:
+            return histograms.blue;
+        case Channel::LUMINANCE:
+        default:
+            return histograms.luminance;
+    }
+}
+
+Histogram::ChannelHistograms Histogram::calculateHistograms(const std::unique_ptr<Image>& image, Mode mode) {
+    // Histogramy zapamiętane przy obrazie: zliczane są tylko kafelki zmienione od ostatniego
+    // zapytania, a po operacjach LUT nic nie trzeba liczyć od nowa. Kafelki są liczone
+    // równolegle, każdy do własnych liczników, więc wynik nie zależy od trybu.
+    auto totals = image->histogramCache().totals(*image, mode == Mode::Parallel);
     
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            int value = 0;
-            
-            switch (channel) {
-                case Channel::RED:
-                    value = image->getPixelR(x, y);
-                    break;
-                case Channel::GREEN:
-                    value = image->getPixelG(x, y);
-                    break;
-                case Channel::BLUE:
-                    value = image->getPixelB(x, y);
-                    break;
-                case Channel::LUMINANCE:
-                    value = calculateLuminance(
-                        image->getPixelR(x, y),
-                        image->getPixelG(x, y),
-                        image->getPixelB(x, y)
-                    );
-                    break;
-            }
-            
-            histogram[value]++;
-        }
+    ChannelHistograms result;
+    for (int i = 0; i < 256; ++i) {
+        result.red[i] = static_cast<int>(totals[i]);
+        result.green[i] = static_cast<int>(totals[256 + i]);
+        result.blue[i] = static_cast<int>(totals[2 * 256 + i]);
+        result.luminance[i] = static_cast<int>(totals[3 * 256 + i]);
     }
     
-    return histogram;
+    return result;
 }
 
 std::vector<double> Histogram::normalizeHistogram(const std::array<int, 256>& histogram, int height) {
@@ -87,10 +84,9 @@ void Histogram::stretchHistogram(std::unique_ptr<Image>& image) {
     applyLUT(image, lut);
 }
 
-std::array<int, 256> Histogram::createEqualizationLUT(const std::unique_ptr<Image>& image, Channel channel, int totalPixels) {
+std::array<int, 256> Histogram::createEqualizationLUT(const std::array<int, 256>& histogram, int totalPixels) {
     std::array<int, 256> lut;
 
-    auto histogram = calculateHistogram(image, channel);
     auto cdf = calculateCumulativeHistogram(histogram);
     int cdfMin = findMinNonZero(cdf);
 
@@ -107,31 +103,146 @@ void Histogram::equalizeHistogram(std::unique_ptr<Image>& image) {
     
     std::array<int, 256> lutR, lutG, lutB;
     
-    lutR = createEqualizationLUT(image, Channel::RED, totalPixels);
-    lutG = createEqualizationLUT(image, Channel::GREEN, totalPixels);
-    lutB = createEqualizationLUT(image, Channel::BLUE, totalPixels);
+    // Jeden przebieg po obrazie zamiast trzech
+    auto histograms = calculateHistograms(image);
+    lutR = createEqualizationLUT(histograms.red, totalPixels);
+    lutG = createEqualizationLUT(histograms.green, totalPixels);
+    lutB = createEqualizationLUT(histograms.blue, totalPixels);
+    
+    std::array<uint8_t, 256> tableR, tableG, tableB;
+    for (int i = 0; i < 256; ++i) {
+        tableR[i] = static_cast<uint8_t>(lutR[i]);
+        tableG[i] = static_cast<uint8_t>(lutG[i]);
+        tableB[i] = static_cast<uint8_t>(lutB[i]);
+    }
+    
+    image->applyLUT(tableR.data(), tableG.data(), tableB.data());
+}
+
+void Histogram::claheEqualization(std::unique_ptr<Image>& image, double clipLimit, int gridSize) {
+    if (!image || image->width() == 0 || image->height() == 0) {
+        return;
+    }
     
     int width = image->width();
     int height = image->height();
+    int tilesX = std::clamp(gridSize, 1, width);
+    int tilesY = std::clamp(gridSize, 1, height);
+    int tileCount = tilesX * tilesY;
+    
+    auto tileStartX = [=](int tx) { return static_cast<int>(static_cast<long long>(width) * tx / tilesX); };
+    auto tileStartY = [=](int ty) { return static_cast<int>(static_cast<long long>(height) * ty / tilesY); };
     
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            int r = image->getPixelR(x, y);
-            int g = image->getPixelG(x, y);
-            int b = image->getPixelB(x, y);
+    // Krok 1: obcięte histogramy i tablice LUT kafelków (R, G, B), liczone równolegle.
+    // Każdy piksel jest czytany tylko raz, niezależnie od rozmiaru kafelka.
+    std::vector<uint8_t> luts(static_cast<size_t>(tileCount) * 3 * 256);
+    Parallel::forRange(tileCount, [&](int begin, int end) {
+        for (int tile = begin; tile < end; ++tile) {
+            int tx = tile % tilesX;
+            int ty = tile / tilesX;
+            int x0 = tileStartX(tx), x1 = tileStartX(tx + 1);
+            int y0 = tileStartY(ty), y1 = tileStartY(ty + 1);
+            int tilePixels = (x1 - x0) * (y1 - y0);
             
-            r = lutR[r];
-            g = lutG[g];
-            b = lutB[b];
+            std::array<std::array<int, 256>, 3> histograms{};
+            for (int y = y0; y < y1; ++y) {
+                const QRgb* line = image->constScanLine(y);
+                for (int x = x0; x < x1; ++x) {
+                    histograms[0][qRed(line[x])]++;
+                    histograms[1][qGreen(line[x])]++;
+                    histograms[2][qBlue(line[x])]++;
+                }
+            }
             
-            image->setPixel(x, y, r, g, b);
+            int limit = std::max(1, static_cast<int>(clipLimit * tilePixels / 256.0));
+            for (int c = 0; c < 3; ++c) {
+                clipHistogram(histograms[c], limit);
+                uint8_t* lut = &luts[(static_cast<size_t>(tile) * 3 + c) * 256];
+                long long cdf = 0;
+                for (int i = 0; i < 256; ++i) {
+                    cdf += histograms[c][i];
+                    lut[i] = static_cast<uint8_t>(std::clamp<long long>((cdf * 255 + tilePixels / 2) / tilePixels, 0, 255));
+                }
+            }
         }
-    }
+    }, 1);
+    
+    // Krok 2: dla każdej kolumny i wiersza - sąsiednie środki kafelków i waga interpolacji (0-256)
+    struct Neighbours {
+        std::vector<int> first, second, weight;
+    };
+    auto neighbours = [](int size, int tiles, const auto& tileStart) {
+        Neighbours n{std::vector<int>(size), std::vector<int>(size), std::vector<int>(size)};
+        for (int i = 0; i < size; ++i) {
+            // Kafelek, którego środek leży na lewo od i (lub pierwszy)
+            int t = 0;
+            while (t + 1 < tiles && tileStart(t + 1) + tileStart(t + 2) - 1 <= 2 * i) {
+                ++t;
+            }
+            double c0 = (tileStart(t) + tileStart(t + 1) - 1) / 2.0;
+            double c1 = t + 1 < tiles ? (tileStart(t + 1) + tileStart(t + 2) - 1) / 2.0 : c0;
+            n.first[i] = t;
+            n.second[i] = t + 1 < tiles ? t + 1 : t;
+            double w = c1 > c0 ? (i - c0) / (c1 - c0) : 0.0;
+            n.weight[i] = static_cast<int>(std::lround(std::clamp(w, 0.0, 1.0) * 256));
+        }
+        return n;
+    };
+    Neighbours nx = neighbours(width, tilesX, tileStartX);
+    Neighbours ny = neighbours(height, tilesY, tileStartY);
+    
+    // Krok 3: jeden przebieg po obrazie - dwuliniowa interpolacja między LUT czterech sąsiednich kafelków
+    QRgb* pixels = image->bits();
+    Parallel::forRange(height, [&](int begin, int end) {
+        for (int y = begin; y < end; ++y) {
+            QRgb* line = pixels + static_cast<size_t>(y) * width;
+            int wy = ny.weight[y];
+            size_t rowTop = static_cast<size_t>(ny.first[y]) * tilesX;
+            size_t rowBottom = static_cast<size_t>(ny.second[y]) * tilesX;
+            
+            for (int x = 0; x < width; ++x) {
+                int wx = nx.weight[x];
+                const uint8_t* lutTL = &luts[(rowTop + nx.first[x]) * 3 * 256];
+                const uint8_t* lutTR = &luts[(rowTop + nx.second[x]) * 3 * 256];
+                const uint8_t* lutBL = &luts[(rowBottom + nx.first[x]) * 3 * 256];
+                const uint8_t* lutBR = &luts[(rowBottom + nx.second[x]) * 3 * 256];
+                
+                QRgb p = line[x];
+                int values[3] = {qRed(p), qGreen(p), qBlue(p)};
+                int out[3];
+                for (int c = 0; c < 3; ++c) {
+                    int v = values[c] + c * 256;
+                    int top = lutTL[v] * (256 - wx) + lutTR[v] * wx;
+                    int bottom = lutBL[v] * (256 - wx) + lutBR[v] * wx;
+                    out[c] = (top * (256 - wy) + bottom * wy + 32768) >> 16;
+                }
+                line[x] = qRgb(out[0], out[1], out[2]);
+            }
+        }
+    }, 64);
 }
 
-int Histogram::calculateLuminance(int r, int g, int b) {
-    // Use the standard formula for luminance (same as in Greyscale)
-    return static_cast<int>(0.3 * r + 0.6 * g + 0.1 * b);
+void Histogram::clipHistogram(std::array<int, 256>& histogram, int limit) {
+    int excess = 0;
+    for (int& count : histogram) {
+        if (count > limit) {
+            excess += count - limit;
+            count = limit;
+        }
+    }
+    
+    // Równomierne rozłożenie nadmiaru, reszta co 256 / remainder koszyków
+    int increment = excess / 256;
+    int remainder = excess % 256;
+    for (int& count : histogram) {
+        count += increment;
+    }
+    if (remainder > 0) {
+        int step = std::max(1, 256 / remainder);
+        for (int i = 0; i < 256 && remainder > 0; i += step, --remainder) {
+            histogram[i]++;
+        }
+    }
 }
 
 std::array<int, 256> Histogram::calculateCumulativeHistogram(const std::array<int, 256>& histogram) {
@@ -155,20 +266,10 @@ int Histogram::findMinNonZero(const std::array<int, 256>& histogram) {
 }
 
 void Histogram::applyLUT(std::unique_ptr<Image>& image, const std::array<int, 256>& lut) {
-    int width = image->width();
-    int height = image->height();
-    
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            int r = image->getPixelR(x, y);
-            int g = image->getPixelG(x, y);
-            int b = image->getPixelB(x, y);
-            
-            r = lut[r];
-            g = lut[g];
-            b = lut[b];
-            
-            image->setPixel(x, y, r, g, b);
-        }
+    std::array<uint8_t, 256> table;
+    for (int i = 0; i < 256; ++i) {
+        table[i] = static_cast<uint8_t>(lut[i]);
     }
+    
+    image->applyLUT(table.data(), table.data(), table.data());
 }
@@ -16,7 +16,27 @@ public:
         LUMINANCE
     };
 
-    static std::array<int, 256> calculateHistogram(const std::unique_ptr<Image>& image, Channel channel);
+    // Tryb liczenia: szeregowy lub równoległy (kafelki z prywatnymi licznikami).
+    // Oba tryby dają identyczny wynik.
+    enum class Mode {
+        Serial,
+        Parallel
+    };
+
+    // Histogramy wszystkich kanałów naraz
+    struct ChannelHistograms {
+        std::array<int, 256> red{};
+        std::array<int, 256> green{};
+        std::array<int, 256> blue{};
+        std::array<int, 256> luminance{};
+    };
+
+    static std::array<int, 256> calculateHistogram(const std::unique_ptr<Image>& image, Channel channel,
+                                                   Mode mode = Mode::Parallel);
+    
+    // R, G, B i luminancja w jednym przebiegu po obrazie
+    static ChannelHistograms calculateHistograms(const std::unique_ptr<Image>& image,
+                                                 Mode mode = Mode::Parallel);
     
     // Normalizacja histogramu (do wyświetlania)
     static std::vector<double> normalizeHistogram(const std::array<int, 256>& histogram, int height);
@@ -24,17 +44,22 @@ public:
     static void stretchHistogram(std::unique_ptr<Image>& image);
     
     static void equalizeHistogram(std::unique_ptr<Image>& image);
+    
+    // CLAHE - lokalne wyrównanie histogramu z ograniczeniem kontrastu.
+    // Obraz dzielony jest na gridSize x gridSize kafelków, clipLimit to krotność średniej liczności koszyka.
+    static void claheEqualization(std::unique_ptr<Image>& image, double clipLimit = 2.0, int gridSize = 8);
 
 private:
-    static int calculateLuminance(int r, int g, int b);
-    
     static std::array<int, 256> calculateCumulativeHistogram(const std::array<int, 256>& histogram);
     
     static int findMinNonZero(const std::array<int, 256>& histogram);
     
     static void applyLUT(std::unique_ptr<Image>& image, const std::array<int, 256>& lut);
 
-    static std::array<int, 256> createEqualizationLUT(const std::unique_ptr<Image>& image, Channel channel, int totalPixels);
+    static std::array<int, 256> createEqualizationLUT(const std::array<int, 256>& histogram, int totalPixels);
+    
+    // Obcięcie koszyków powyżej limitu i równomierne rozłożenie nadmiaru
+    static void clipHistogram(std::array<int, 256>& histogram, int limit);
 };
 
 #endif // HISTOGRAM_H
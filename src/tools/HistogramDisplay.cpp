@@ -1,13 +1,134 @@
 #include "HistogramDisplay.h"
+#include <QPainterPath>
+#include <QPromise>
+#include <QThreadPool>
+#include <algorithm>
+#include <cmath>
+
+void HistogramWidget::setHistogramData(const std::array<int, 256>& data, QColor color) {
+    histogramData = data;
+    histogramColor = color;
+    updateLevels();
+}
+
+void HistogramWidget::setLogScale(bool enabled) {
+    if (logScale == enabled) {
+        return;
+    }
+    logScale = enabled;
+    updateLevels();
+}
+
+void HistogramWidget::updateLevels() {
+    // Skalowanie liczone raz przy zmianie danych, a nie przy każdym odrysowaniu
+    int maxValue = std::max(1, *std::max_element(histogramData.begin(), histogramData.end()));
+    double maxLevel = logScale ? std::log1p(static_cast<double>(maxValue)) : maxValue;
+    for (int i = 0; i < 256; i++) {
+        double value = logScale ? std::log1p(static_cast<double>(histogramData[i])) : histogramData[i];
+        levels[i] = value / maxLevel;
+    }
+    cacheValid = false;
+    update();
+}
+
+void HistogramWidget::renderCache() {
+    qreal ratio = devicePixelRatioF();
+    cache = QImage(size() * ratio, QImage::Format_ARGB32_Premultiplied);
+    cache.setDevicePixelRatio(ratio);
+
+    QPainter painter(&cache);
+
+    // Rozmiary widgetu
+    int width = this->width();
+    int height = this->height();
+    int bottom = height - 20; // Pozostaw miejsce na oś X
+
+    // Rysuj tło
+    painter.fillRect(rect(), Qt::white);
+
+    // Rysuj ramkę
+    painter.setPen(Qt::gray);
+    painter.drawRect(0, 0, width - 1, height - 1);
+
+    // Rysuj oś X
+    painter.drawLine(0, bottom, width, bottom);
+
+    // Rysuj znaczniki na osi X
+    painter.setPen(Qt::black);
+    painter.drawText(0, bottom + 15, "0");
+    painter.drawText(width - 20, bottom + 15, "255");
+    if (logScale) {
+        painter.drawText(width / 2 - 10, bottom + 15, "log");
+    }
+
+    // Cały histogram jako jeden wielokąt schodkowy zamiast setek osobnych linii
+    double binWidth = static_cast<double>(width) / 256;
+    QPainterPath path(QPointF(0, bottom));
+    for (int i = 0; i < 256; i++) {
+        double top = bottom - levels[i] * bottom;
+        path.lineTo(i * binWidth, top);
+        path.lineTo((i + 1) * binWidth, top);
+    }
+    path.lineTo(width, bottom);
+    path.closeSubpath();
+
+    QColor fill = histogramColor;
+    fill.setAlpha(96);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(histogramColor);
+    painter.setBrush(fill);
+    painter.drawPath(path);
+
+    cacheValid = true;
+}
+
+void HistogramWidget::paintEvent(QPaintEvent* event) {
+    Q_UNUSED(event);
+    if (!cacheValid || cache.deviceIndependentSize().toSize() != size()) {
+        renderCache();
+    }
+
+    QPainter painter(this);
+    painter.drawImage(0, 0, cache);
+}
+
+namespace {
+
+// Niezależna kopia obrazu razem z zapamiętanymi histogramami - wątek roboczy nie dotyka
+// obrazu, który w tym czasie mogą modyfikować narzędzia
+class ImageSnapshot : public Image {
+public:
+    // Bufor pikseli współdzielony ze źródłem - kopiowany jest tylko cache kafelków
+    explicit ImageSnapshot(const Image& source) : Image(source) {}
+
+    bool load(const QString&) override { return false; }
+    bool save(const QString&) const override { return false; }
+};
+
+// Opóźnienie przeliczenia po zmianie obrazu (ms)
+constexpr int RefreshDelay = 150;
+
+} // namespace
 
 HistogramDisplay::HistogramDisplay(const std::unique_ptr<Image>& image, QWidget* parent)
-    : QDialog(parent) {
+    : QDialog(parent), sourceImage(image) {
     
     setWindowTitle("Image Histogram");
     setMinimumSize(650, 500);
     
     setupUI();
-    calculateHistograms(image);
+
+    refreshTimer.setSingleShot(true);
+    refreshTimer.setInterval(RefreshDelay);
+    connect(&refreshTimer, &QTimer::timeout, this, &HistogramDisplay::calculateHistograms);
+    connect(&watcher, &QFutureWatcher<std::shared_ptr<Job>>::finished, this, &HistogramDisplay::histogramsReady);
+
+    // Okno pojawia się od razu, histogramy dochodzą gdy będą gotowe
+    calculateHistograms();
+}
+
+void HistogramDisplay::imageChanged() {
+    refreshTimer.start();
 }
 
 void HistogramDisplay::setupUI() {
@@ -48,29 +169,92 @@ void HistogramDisplay::setupUI() {
     mainLayout->addLayout(blueLayout);
     mainLayout->addLayout(luminanceLayout);
     
+    logScaleCheckBox = new QCheckBox("Logarithmic scale", this);
+    connect(logScaleCheckBox, &QCheckBox::toggled, this, [this](bool checked) {
+        redHistogram->setLogScale(checked);
+        greenHistogram->setLogScale(checked);
+        blueHistogram->setLogScale(checked);
+        luminanceHistogram->setLogScale(checked);
+    });
+    
     auto* closeButton = new QPushButton("Close", this);
     connect(closeButton, &QPushButton::clicked, this, &QDialog::accept);
     
+    statusLabel = new QLabel(this);
+    
     auto* buttonLayout = new QHBoxLayout();
+    buttonLayout->addWidget(logScaleCheckBox);
     buttonLayout->addStretch();
+    buttonLayout->addWidget(statusLabel);
     buttonLayout->addWidget(closeButton);
     mainLayout->addLayout(buttonLayout);
     
     setLayout(mainLayout);
 }
 
-void HistogramDisplay::calculateHistograms(const std::unique_ptr<Image>& image) {
+void HistogramDisplay::calculateHistograms() {
+    const Image* image = sourceImage.get();
     if (!image) {
         return;
     }
+    if (image->id() == shownId && image->generation() == shownGeneration) {
+        return;
+    }
+    if (watcher.isRunning()) {
+        // Jedno zadanie naraz - kolejne ruszy po zakończeniu bieżącego
+        refreshPending = true;
+        return;
+    }
+    
+    if (image->histogramCache().isCurrent(*image)) {
+        // Nic do zliczenia (np. po applyLUT na obrazie szarym) - samo sumowanie kafelków, bez migawki i wątku
+        showHistograms(Histogram::calculateHistograms(sourceImage), image->id(), image->generation());
+        return;
+    }
     
-    auto redData = Histogram::calculateHistogram(image, Histogram::Channel::RED);
-    auto greenData = Histogram::calculateHistogram(image, Histogram::Channel::GREEN);
-    auto blueData = Histogram::calculateHistogram(image, Histogram::Channel::BLUE);
-    auto luminanceData = Histogram::calculateHistogram(image, Histogram::Channel::LUMINANCE);
+    statusLabel->setText("Computing...");
     
-    redHistogram->setHistogramData(redData, Qt::red);
-    greenHistogram->setHistogramData(greenData, Qt::green);
-    blueHistogram->setHistogramData(blueData, Qt::blue);
-    luminanceHistogram->setHistogramData(luminanceData, Qt::black);
+    auto job = std::make_shared<Job>();
+    // Migawka powstaje na wątku GUI, ale nie kopiuje pikseli: bierze referencję do bufora,
+    // a narzędzie, które zapisze do obrazu w trakcie liczenia, samo zrobi sobie kopię.
+    job->snapshot = std::make_unique<ImageSnapshot>(*image);
+    job->sourceId = image->id();
+    job->sourceGeneration = image->generation();
+    
+    auto promise = std::make_shared<QPromise<std::shared_ptr<Job>>>();
+    watcher.setFuture(promise->future());
+    promise->start();
+    QThreadPool::globalInstance()->start([promise, job]() {
+        // Wszystkie cztery histogramy w jednym przebiegu po obrazie
+        job->histograms = Histogram::calculateHistograms(job->snapshot);
+        promise->addResult(job);
+        promise->finish();
+    });
+}
+
+void HistogramDisplay::showHistograms(const Histogram::ChannelHistograms& histograms,
+                                      uint64_t sourceId, uint64_t sourceGeneration) {
+    redHistogram->setHistogramData(histograms.red, Qt::red);
+    greenHistogram->setHistogramData(histograms.green, Qt::green);
+    blueHistogram->setHistogramData(histograms.blue, Qt::blue);
+    luminanceHistogram->setHistogramData(histograms.luminance, Qt::black);
+    shownId = sourceId;
+    shownGeneration = sourceGeneration;
+}
+
+void HistogramDisplay::histogramsReady() {
+    std::shared_ptr<Job> job = watcher.result();
+    showHistograms(job->histograms, job->sourceId, job->sourceGeneration);
+    
+    // Obraz nie zmienił się w trakcie liczenia - przeliczone kafelki wracają do jego cache
+    const Image* image = sourceImage.get();
+    if (image && image->id() == job->sourceId && image->generation() == job->sourceGeneration) {
+        image->histogramCache() = std::move(job->snapshot->histogramCache());
+    }
+    
+    statusLabel->clear();
+    if (refreshPending) {
+        refreshPending = false;
+        calculateHistograms();
+    }
 }
@@ -8,12 +8,17 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QPushButton>
+#include <QCheckBox>
+#include <QImage>
+#include <QTimer>
+#include <QFutureWatcher>
 #include <array>
 #include <memory>
 #include "../image/Image.h"
 #include "Histogram.h"
 
-// Widget do rysowania pojedynczego histogramu
+// Widget do rysowania pojedynczego histogramu.
+// Wykres jest rysowany raz do bufora i odświeżany tylko po zmianie danych, skali lub rozmiaru.
 class HistogramWidget : public QWidget {
     Q_OBJECT
 
@@ -22,77 +27,49 @@ public:
         setMinimumSize(256, 150);
     }
 
-    void setHistogramData(const std::array<int, 256>& data, QColor color) {
-        histogramData = data;
-        histogramColor = color;
-        update();
-    }
+    void setHistogramData(const std::array<int, 256>& data, QColor color);
+    void setLogScale(bool enabled);
 
 protected:
-    void paintEvent(QPaintEvent* event) override {
-        QPainter painter(this);
-        painter.setRenderHint(QPainter::Antialiasing);
-        
-        // Znajdź maksymalną wartość w histogramie do skalowania
-        int maxValue = 1; // Unikaj dzielenia przez zero
-        for (int value : histogramData) {
-            maxValue = std::max(maxValue, value);
-        }
-        
-        // Rozmiary widgetu
-        int width = this->width();
-        int height = this->height();
-        int bottom = height - 20; // Pozostaw miejsce na oś X
-        
-        // Rysuj tło
-        painter.fillRect(rect(), Qt::white);
-        
-        // Rysuj ramkę
-        painter.setPen(Qt::gray);
-        painter.drawRect(0, 0, width - 1, height - 1);
-        
-        // Rysuj oś X
-        painter.drawLine(0, bottom, width, bottom);
-        
-        // Rysuj znaczniki na osi X
-        painter.setPen(Qt::black);
-        painter.drawText(0, bottom + 15, "0");
-        painter.drawText(width - 20, bottom + 15, "255");
-        
-        // Ustaw kolor histogramu
-        painter.setPen(histogramColor);
-        
-        // Rysuj histogram
-        double binWidth = static_cast<double>(width) / 256;
-        for (int i = 0; i < 256; i++) {
-            int binHeight = static_cast<int>((static_cast<double>(histogramData[i]) / maxValue) * bottom);
-            int x1 = static_cast<int>(i * binWidth);
-            int x2 = static_cast<int>((i + 1) * binWidth);
-            
-            // Rysuj linię histogramu
-            if (binHeight > 0) {
-                painter.drawLine(x1, bottom, x1, bottom - binHeight);
-                if (x2 - x1 > 1) { // Jeśli słupek jest szerszy niż 1 piksel
-                    painter.drawLine(x1, bottom - binHeight, x2, bottom - binHeight);
-                    painter.drawLine(x2, bottom - binHeight, x2, bottom);
-                }
-            }
-        }
-    }
+    void paintEvent(QPaintEvent* event) override;
 
 private:
     std::array<int, 256> histogramData{};
+    std::array<double, 256> levels{}; // Wysokości słupków w zakresie 0-1
     QColor histogramColor = Qt::black;
+    bool logScale = false;
+    QImage cache;
+    bool cacheValid = false;
+
+    void updateLevels();
+    void renderCache();
 };
 
-// Główne okno dialogowe wyświetlające histogramy
+// Główne okno dialogowe wyświetlające histogramy.
+// Histogramy liczone są w tle na migawce obrazu (bez kopiowania pikseli); po zmianach obrazu
+// (imageChanged) okno odświeża się samo, z opóźnieniem, aby seria szybkich zmian dała jedno przeliczenie.
 class HistogramDisplay : public QDialog {
     Q_OBJECT
 
 public:
     explicit HistogramDisplay(const std::unique_ptr<Image>& image, QWidget* parent = nullptr);
 
+public slots:
+    // Obraz został zmodyfikowany lub zastąpiony
+    void imageChanged();
+
 private:
+    // Zadanie dla wątku roboczego: migawka obrazu i wynik. Źródło rozpoznawane po identyfikatorze
+    // i numerze modyfikacji - adres obrazu może zostać użyty ponownie przez nowo wczytany plik.
+    struct Job {
+        std::unique_ptr<Image> snapshot;
+        uint64_t sourceId = 0;
+        uint64_t sourceGeneration = 0;
+        Histogram::ChannelHistograms histograms;
+    };
+
+    const std::unique_ptr<Image>& sourceImage;
+
     HistogramWidget* redHistogram;
     HistogramWidget* greenHistogram;
     HistogramWidget* blueHistogram;
@@ -102,9 +79,20 @@ private:
     QLabel* greenLabel;
     QLabel* blueLabel;
     QLabel* luminanceLabel;
+    QLabel* statusLabel;
+    QCheckBox* logScaleCheckBox;
+
+    QTimer refreshTimer;
+    QFutureWatcher<std::shared_ptr<Job>> watcher;
+    bool refreshPending = false;
+    uint64_t shownId = 0; // 0 - jeszcze nic nie wyświetlono
+    uint64_t shownGeneration = UINT64_MAX;
     
     void setupUI();
-    void calculateHistograms(const std::unique_ptr<Image>& image);
+    void calculateHistograms();
+    void showHistograms(const Histogram::ChannelHistograms& histograms,
+                        uint64_t sourceId, uint64_t sourceGeneration);
+    void histogramsReady();
 };
 
 #endif // HISTOGRAMDISPLAY_H
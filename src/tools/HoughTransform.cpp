@@ -1,6 +1,7 @@
 #include "HoughTransform.h"
 #include "Greyscale.h"
 #include "EdgeDetection.h"
+#include "../core/Convolution.h"
 #include "../image/PPM.h"
 #include <algorithm>
 #include <QColor>
@@ -212,28 +213,23 @@ void HoughTransform::applyEdgeDetection(std::unique_ptr<Image>& image) {
 void HoughTransform::applyLaplacianOnArray(std::vector<std::vector<int>>& arr, int width, int height) {
     // Generate Laplacian kernel
     std::vector<std::vector<double>> kernel = EdgeDetection::generateLaplacianKernel(3);
-    int kernelSize = 3;
-    int kernelRadius = kernelSize / 2;
     
-    // Create a copy of the original array for convolution
-    std::vector<std::vector<int>> original = arr;
+    // Flat copy of arr[x][y] as the convolution source
+    std::vector<float> original(static_cast<size_t>(width) * height);
+    for (int x = 0; x < width; x++) {
+        for (int y = 0; y < height; y++) {
+            original[static_cast<size_t>(y) * width + x] = static_cast<float>(arr[x][y]);
+        }
+    }
     
     // Apply Laplacian convolution
-    for (int j = kernelRadius; j < height - kernelRadius; j++) {
-        for (int i = kernelRadius; i < width - kernelRadius; i++) {
-            double sum = 0;
-            
-            // Apply convolution
-            for (int ky = 0; ky < kernelSize; ky++) {
-                for (int kx = 0; kx < kernelSize; kx++) {
-                    int pixelY = j - kernelRadius + ky;
-                    int pixelX = i - kernelRadius + kx;
-                    sum += original[pixelY][pixelX] * kernel[ky][kx];
-                }
-            }
-            
-            // Clamp the result to valid range
-            arr[j][i] = std::max(0, std::min(255, static_cast<int>(sum)));
+    std::vector<float> response(original.size());
+    Convolution::applyPlane(original.data(), response.data(), width, height, kernel);
+    
+    // Clamp the result to valid range
+    for (int x = 0; x < width; x++) {
+        for (int y = 0; y < height; y++) {
+            arr[x][y] = std::max(0, std::min(255, static_cast<int>(response[static_cast<size_t>(y) * width + x])));
         }
     }
 }
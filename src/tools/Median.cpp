@@ -0,0 +1,139 @@
+#include "Median.h"
+#include "../core/Parallel.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+// Histogram dwupoziomowy: 256 koszyków dokładnych + 16 zgrubnych (po 16 wartości),
+// dzięki czemu szukanie mediany przegląda najwyżej 32 koszyki
+constexpr int Bins = 256;
+constexpr int CoarseBins = 16;
+constexpr int HistogramSize = Bins + CoarseBins;
+
+inline void addValue(uint16_t* histogram, int value) {
+    histogram[value]++;
+    histogram[Bins + (value >> 4)]++;
+}
+
+inline void removeValue(uint16_t* histogram, int value) {
+    histogram[value]--;
+    histogram[Bins + (value >> 4)]--;
+}
+
+// Stała długość pętli - kompilator zamienia je na operacje wektorowe
+inline void addHistogram(uint16_t* dst, const uint16_t* src) {
+    for (int i = 0; i < HistogramSize; ++i) {
+        dst[i] += src[i];
+    }
+}
+
+inline void subtractHistogram(uint16_t* dst, const uint16_t* src) {
+    for (int i = 0; i < HistogramSize; ++i) {
+        dst[i] -= src[i];
+    }
+}
+
+// Wartość o pozycji rank (liczonej od zera) w histogramie
+inline int findRank(const uint16_t* histogram, int rank) {
+    int sum = 0;
+    int coarse = 0;
+    while (sum + histogram[Bins + coarse] <= rank) {
+        sum += histogram[Bins + coarse];
+        ++coarse;
+    }
+    int value = coarse * 16;
+    while (true) {
+        sum += histogram[value];
+        if (sum > rank) {
+            return value;
+        }
+        ++value;
+    }
+}
+
+} // namespace
+
+void Median::medianFilter(std::unique_ptr<Image>& image, int radius) {
+    if (!image || radius <= 0) {
+        return;
+    }
+    radius = std::min(radius, MaxRadius);
+
+    int width = image->width();
+    int height = image->height();
+    int rank = (2 * radius + 1) * (2 * radius + 1) / 2;
+
+    // Kopia źródła - wynik zapisywany jest bezpośrednio do obrazu
+    std::vector<QRgb> source(image->constBits(), image->constBits() + image->pixelCount());
+    QRgb* output = image->bits();
+
+    auto clampX = [width](int x) { return std::clamp(x, 0, width - 1); };
+    auto clampY = [height](int y) { return std::clamp(y, 0, height - 1); };
+
+    // Każdy pas wierszy buduje własne histogramy kolumn, więc pasy są niezależne.
+    // Pas musi być znacznie wyższy niż okno, aby koszt inicjalizacji był pomijalny.
+    Parallel::forRange(height, [&](int begin, int end) {
+        std::vector<uint16_t> columns(static_cast<size_t>(width) * 3 * HistogramSize, 0);
+        std::vector<uint16_t> window(3 * HistogramSize);
+        auto column = [&](int x, int channel) {
+            return &columns[(static_cast<size_t>(x) * 3 + channel) * HistogramSize];
+        };
+
+        auto addRow = [&](int y) {
+            const QRgb* line = source.data() + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; ++x) {
+                addValue(column(x, 0), qRed(line[x]));
+                addValue(column(x, 1), qGreen(line[x]));
+                addValue(column(x, 2), qBlue(line[x]));
+            }
+        };
+        auto removeRow = [&](int y) {
+            const QRgb* line = source.data() + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; ++x) {
+                removeValue(column(x, 0), qRed(line[x]));
+                removeValue(column(x, 1), qGreen(line[x]));
+                removeValue(column(x, 2), qBlue(line[x]));
+            }
+        };
+
+        // Histogramy kolumn dla pierwszego wiersza pasa (brzegi powielane)
+        for (int dy = -radius; dy <= radius; ++dy) {
+            addRow(clampY(begin + dy));
+        }
+
+        for (int y = begin; y < end; ++y) {
+            if (y > begin) {
+                // Przesunięcie histogramów kolumn o jeden wiersz w dół
+                removeRow(clampY(y - radius - 1));
+                addRow(clampY(y + radius));
+            }
+
+            // Histogram okna dla x = 0
+            std::fill(window.begin(), window.end(), 0);
+            for (int dx = -radius; dx <= radius; ++dx) {
+                for (int c = 0; c < 3; ++c) {
+                    addHistogram(&window[c * HistogramSize], column(clampX(dx), c));
+                }
+            }
+
+            QRgb* line = output + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; ++x) {
+                line[x] = qRgb(findRank(&window[0], rank),
+                               findRank(&window[HistogramSize], rank),
+                               findRank(&window[2 * HistogramSize], rank));
+
+                // Przesunięcie okna w prawo: jedna kolumna wchodzi, jedna wychodzi
+                int incoming = clampX(x + radius + 1);
+                int outgoing = clampX(x - radius);
+                if (x + 1 < width && incoming != outgoing) {
+                    for (int c = 0; c < 3; ++c) {
+                        addHistogram(&window[c * HistogramSize], column(incoming, c));
+                        subtractHistogram(&window[c * HistogramSize], column(outgoing, c));
+                    }
+                }
+            }
+        }
+    }, std::max(64, 4 * radius));
+}
@@ -0,0 +1,17 @@
+#ifndef MEDIAN_H
+#define MEDIAN_H
+
+#include <memory>
+#include "../image/Image.h"
+
+class Median {
+public:
+    // Filtr medianowy z oknem (2 * radius + 1) x (2 * radius + 1), osobno dla kanałów R, G, B.
+    // Metoda Perreault-Hébert: histogramy kolumn przesuwane w dół obrazu i histogram okna
+    // przesuwany w prawo - koszt na piksel nie zależy od promienia.
+    static void medianFilter(std::unique_ptr<Image>& image, int radius);
+
+    static constexpr int MaxRadius = 127;
+};
+
+#endif // MEDIAN_H